@@ -2,17 +2,30 @@
 #define ARRAYBASEDLIST_H
 
 /**--ArrayBasedList.h-----------------------------------------------------------------------------
-    This template class is responsible for a singly linked list, storing its nodes in a
+    This template class is responsible for a doubly linked list, storing its nodes in a
     fixed-size array list. Also, multiple basic linked list operations are conducted
     through this class which we will view later.
 
     Basic Operations:
-    Constructor: Creates an empty list
+    Constructor: Creates an empty list, optionally with a memory resource used by
+                 the elements (for example ArrayBasedList<pmr::string>)
     Copy Constructor: Creates a deep copy of an existing list
     Assignment Operator: Assigns one List object to another, performing
                          a deep copy.
+    (Both clone the whole storage pool in one block copy when ElementType is
+    trivially copyable; see CowArrayBasedList.h for copies sharing one pool)
     Destructor : Cleans up memory used by the list
+    clear: Removes every element at once, in O(1)
     Getters: Gives access to private data fields such as size, first....
+    setAllocationPolicy: Selects how the storage pool chooses new nodes (see NodePool.h);
+    LOWEST_INDEX_POLICY keeps the list packed at the beginning of the pool
+    setReorderPolicy: Makes the list self-organizing: every successful search (and the
+    lookup of insertAfter) moves the found node towards the head, so the elements
+    looked up most often are found after fewer hops (MOVE_TO_FRONT, TRANSPOSE or
+    COUNT_ORDER; NO_REORDER by default). COUNT_ORDER needs one access counter per node,
+    which only lists with CountAccesses = true have, for example
+    ArrayBasedList<int, 1000, 0, equal_to<>, hash<int>, true>; the other lists pay
+    nothing for it.
 
 
     **Insertion Operations**
@@ -20,6 +33,7 @@
     insertLast: insert an element at the tail of the list
     insertAtPos: insert an element at a given valid position
     insertAfter: insert an element after a given element in the list
+    appendAll: insert several elements at the tail, in contiguous nodes when possible
 
     **Deletion Operations**
     deleteFirst: removes the head from the list
@@ -27,19 +41,58 @@
     deleteAtPos: removes an element at a given valid position
     deleteElement: delete a given element from the list
 
+    **Handle Operations** (O(1), no search; see NodeHandle in NodePool.h)
+    The insertion operations return a handle to the new node, which stays usable
+    until that node is deleted; stale handles are detected and rejected. After a
+    copy, no handle of the source is valid in the copy, and no handle made before an
+    assignment is valid in the assigned list. A handle does not record its list,
+    though: a handle of another list is only rejected if it is stale in this one, so
+    it must never be given to another list.
+    isValid: checks whether a handle still refers to a node of the list
+    erase: deletes the node of a handle
+    insertAfter (handle): inserts an element right after the node of a handle
+    update: replaces the element of the node of a handle
+
+    **Batch Operations** (one traversal of the list for many changes)
+    applyBatch: applies several insertions/deletions given by their original positions
+    (the nodes of the deleted elements are reused by the insertions, so a batch only
+    needs free nodes for the insertions that outnumber the deletions)
+    removeIf: removes every element satisfying a condition
+    removeAll: removes every occurrence of a given element
+
     **Other**
     search : search the list for a node containing a given element
     and returns its position
+    searchMany: searches for several elements in a single traversal
+    searchNoReorder: searches without applying the reorder policy
     reverse: reverse the current list; (head become tail) and each node points to
     its predecessor (this is an exercise in the book chapter 6)
     display: outputs the list from head to tail
+    rdisplay: outputs the list from tail to head without relinking any node
+    forEachReverse: applies a function to every element from tail to head
+    reversed: returns a read-only view of the list usable in a range-based for loop,
+    visiting the elements from tail to head
+
+    **Key Policies**
+    search, searchMany, insertAfter, deleteElement and removeAll compare the elements
+    with the searched key through KeyEqual (equal_to<ElementType> by default, so a key
+    of another type is converted to ElementType first, as with any function taking an
+    ElementType: ArrayBasedList<int>::search(3.5) looks for 3). Transparency is opt-in:
+    with a transparent KeyEqual (it defines is_transparent, as equal_to<> does), they
+    also accept keys of another type, which are compared directly with the elements:
+    for example ArrayBasedList<string, 100, 0, equal_to<>>::search("abc") or
+    search(string_view) builds no temporary string, and search(3.5) on such a list of
+    int finds nothing. A custom KeyEqual (see StringPolicies.h) gives case-insensitive
+    or prefix lookups. Hash is only used by searchMany for many keys; it must agree with
+    KeyEqual, so it defaults to void (no hashing) for a custom KeyEqual.
 
     Overloaded Operator: Sends the elements of the list to the output stream
 
     Class Invariants:
     1. Size is the number of nodes in the list
     2. Position of the first element is 0, of the second 1 and etc...
-    3. first == NULL_VALUE means the list is empty
+    3. first == NULL_VALUE means the list is empty, and then last == NULL_VALUE too;
+    otherwise last is the index of the tail
     4. No invalid indices can be found in the list: we make sure that were always
     respecting the list boundaries
     5. The insertion after an element means inserting after the first occurrence of it
@@ -47,29 +100,391 @@
 
 -------------------------------------------------------------------------------------------*/
 #include "NodePool.h"
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 using namespace std;
 
-template <typename ElementType> // A template class where a type is selected by the user
-                                // to all variables of type ElementType
+// How a successful search reorders the list (see ArrayBasedList::setReorderPolicy)
+enum ReorderPolicy
+{
+    NO_REORDER,    // the list keeps its order
+    MOVE_TO_FRONT, // the found node becomes the head
+    TRANSPOSE,     // the found node is swapped with its predecessor
+    COUNT_ORDER    // the nodes are kept sorted by decreasing number of accesses
+};
+
+template <typename ElementType,          // A template class where a type is selected by the user
+                                        // to all variables of type ElementType
+          int Capacity = NUM_NODES,      // The maximum number of elements (size of the storage pool)
+          size_t NodeAlignment = 0,      // Alignment of the nodes in the pool (see NodePool.h)
+          typename KeyEqual = equal_to<ElementType>, // How an element is compared with a searched key
+          typename Hash =                // Hash consistent with KeyEqual, or void for none
+          conditional_t<is_same_v<KeyEqual, equal_to<ElementType>> || is_same_v<KeyEqual, equal_to<>>,
+                        hash<ElementType>, void>,
+          bool CountAccesses = false>    // One access counter per node, for COUNT_ORDER
 class ArrayBasedList
 { // Forward Declaration
 private:
-    NodePool<ElementType> storagePool; // Fixed size of nodes used to store elemets
+    NodePool<ElementType, Capacity, NodeAlignment> storagePool; // Fixed size of nodes used to store elemets
     NodePtr first;                     // index of the first node of the list
+    NodePtr last;                      // index of the last node of the list
     int size;                          // keeps track of number of elements in the list
+    ReorderPolicy reorderPolicy;       // how a successful search reorders the list
+    struct NoAccessCounts {};          // takes no space: the list does not count accesses
+    [[no_unique_address]] conditional_t<CountAccesses, unsigned[Capacity], NoAccessCounts>
+        accessCount;                   // number of accesses to each node (COUNT_ORDER)
+
+    // Up to this number of keys, searchMany compares every node with every key
+    static const int SMALL_KEY_SET = 8;
+
+    // Keys of another type than ElementType are accepted when KeyEqual is transparent
+    static constexpr bool TRANSPARENT_KEYS = requires { typename KeyEqual::is_transparent; };
+
+    /***** matches *****/
+    /*-------------------------------------------------------------------------
+     Compares the data of a node with a searched key, using the KeyEqual policy.
+     -------------------------------------------------------------------------*/
+    template <typename Key>
+    constexpr static bool matches(const ElementType &data, const Key &key)
+    {
+        return KeyEqual()(data, key);
+    }
+
+    /***** hashesKeys *****/
+    /*-------------------------------------------------------------------------
+     Tells whether keys of type Key and the elements can be hashed with Hash
+     (Hash is not void, accepts both, and is transparent if Key is another type).
+     -------------------------------------------------------------------------*/
+    template <typename Key>
+    static constexpr bool hashesKeys()
+    {
+        if constexpr (is_void_v<Hash>)
+            return false;
+        else
+            return requires(const Hash &hasher, const Key &key, const ElementType &data) {
+                hasher(key);
+                hasher(data);
+            } && (is_same_v<Key, ElementType> || requires { typename Hash::is_transparent; });
+    }
+
+    /***** report *****/
+    /*-------------------------------------------------------------------------
+     Displays a message made of several parts, followed by a new line. Nothing
+     is displayed during constant evaluation, so every operation that reports
+     its result can still be used to build a list at compile time.
+
+     Precondition: Every part can be sent to an output stream
+     Post-condition: At run time, the parts are printed to cout
+     -------------------------------------------------------------------------*/
+    template <typename... Parts>
+    constexpr void report(const Parts &...parts) const
+    {
+        if (!is_constant_evaluated())
+        {
+            (cout << ... << parts) << endl;
+        }
+    }
+
+    /***** linkBetween *****/
+    /*-------------------------------------------------------------------------
+     Links node between pred and succ, updating the next and prev indices around
+     it. pred == NULL_VALUE means node becomes the head, succ == NULL_VALUE the tail.
+
+     Precondition: pred and succ are adjacent in the list (or NULL_VALUE)
+     Post-condition: pred -> node -> succ; first and last are updated if needed,
+     and the access count of node (if accesses are counted) is 0
+     -------------------------------------------------------------------------*/
+    constexpr void linkBetween(NodePtr node, NodePtr pred, NodePtr succ)
+    {
+        if constexpr (CountAccesses)
+            accessCount[node] = 0; // a new node of the list was never accessed
+        storagePool.getNode(node).prev = pred;
+        storagePool.getNode(node).next = succ;
+        if (pred == NULL_VALUE)
+            first = node; // node is the new head
+        else
+            storagePool.getNode(pred).next = node;
+        if (succ == NULL_VALUE)
+            last = node; // node is the new tail
+        else
+            storagePool.getNode(succ).prev = node;
+    }
+
+    /***** unlink *****/
+    /*-------------------------------------------------------------------------
+     Removes node from the list in O(1) using its prev index. The node itself
+     is not freed.
+
+     Precondition: node is in the list
+     Post-condition: The predecessor and successor of node are linked together;
+     first and last are updated if needed
+     -------------------------------------------------------------------------*/
+    constexpr void unlink(NodePtr node)
+    {
+        NodePtr pred = storagePool.getNode(node).prev;
+        NodePtr succ = storagePool.getNode(node).next;
+        if (pred == NULL_VALUE)
+            first = succ; // node was the head
+        else
+            storagePool.getNode(pred).next = succ;
+        if (succ == NULL_VALUE)
+            last = pred; // node was the tail
+        else
+            storagePool.getNode(succ).prev = pred;
+    }
+
+    /***** removeMatching *****/
+    /*-------------------------------------------------------------------------
+     Unlinks every node whose data satisfies matches, in one traversal. The removed
+     nodes are chained together while traversing and returned to the storage pool
+     with one splice at the end.
+
+     Precondition: matches must be callable with a const ElementType&
+     Post-condition: No element satisfies matches; returns the number of removed nodes
+     -------------------------------------------------------------------------*/
+    template <typename Predicate>
+    constexpr int removeMatching(Predicate matches)
+    {
+        NodePtr ptr = first;              // Start from head of the list
+        NodePtr removedHead = NULL_VALUE; // chain of removed nodes
+        NodePtr removedTail = NULL_VALUE;
+        int removed = 0;
+        // Traverse till the end
+        while (ptr != NULL_VALUE)
+        {
+            NodePtr next = storagePool.getNode(ptr).next; // save next node
+            if (matches(storagePool.getNode(ptr).data))
+            {
+                unlink(ptr); // unlink ptr from the list
+                // and append it to the chain of removed nodes
+                if (removedTail == NULL_VALUE)
+                    removedHead = ptr;
+                else
+                    storagePool.getNode(removedTail).next = ptr;
+                removedTail = ptr;
+                removed++;
+            }
+            ptr = next; // move forward
+        }
+        // All the removed nodes go back to the free list at once
+        if (removedHead != NULL_VALUE)
+        {
+            storagePool.returnChain(removedHead, removedTail);
+        }
+        size -= removed;
+        return removed;
+    }
+
+    /***** nodeAt *****/
+    /*-------------------------------------------------------------------------
+     Returns the node at a position, walking from the head or, using the prev
+     indices, from the tail, whichever is closer (at most size / 2 hops).
+     Unlike walkFromBothEnds, it follows a single chain: the index of each node
+     is only known once the previous node is loaded, so there is nothing to
+     prefetch, and on a large scattered pool every hop waits for memory.
+
+     Precondition: pos is in the range [0, size - 1]
+     Post-condition: Returns the index of the node at position pos
+     -------------------------------------------------------------------------*/
+    constexpr NodePtr nodeAt(unsigned pos) const
+    {
+        if (pos < unsigned(size) / 2)
+        {
+            NodePtr ptr = first; // from the head
+            for (unsigned count = 0; count < pos; count++)
+                ptr = storagePool.getNode(ptr).next;
+            return ptr;
+        }
+        NodePtr ptr = last; // from the tail
+        for (unsigned count = size - 1; count > pos; count--)
+            ptr = storagePool.getNode(ptr).prev;
+        return ptr;
+    }
+
+    /***** walkFromBothEnds *****/
+    /*-------------------------------------------------------------------------
+     Visits every node once with two cursors moving towards each other: one from
+     the head along the next indices, one from the tail along the prev indices.
+     The two walks do not depend on each other, so the processor waits for two
+     node loads at a time instead of one, and the next node of each walk is
+     prefetched before the current ones are visited. A traversal of a large pool,
+     bound by memory latency, takes about half the time of a walk from the head.
+
+     visit(node, data, pos, fromHead) is called for every node (the head cursor first
+     at every step); it returns true to stop the walk. A node visited by the head
+     cursor comes after all the nodes already visited by that cursor; a node
+     visited by the tail cursor may be preceded by nodes not visited yet.
+
+     Precondition: visit must be callable with (NodePtr, const ElementType&, int, bool)
+     Post-condition: Every node was visited once, unless visit stopped the walk
+     -------------------------------------------------------------------------*/
+    template <typename Visitor>
+    constexpr void walkFromBothEnds(Visitor visit) const
+    {
+        NodePtr front = first; // head cursor
+        NodePtr back = last;   // tail cursor
+        int frontPos = 0;
+        int backPos = size - 1;
+        while (frontPos <= backPos)
+        {
+            NodePtr frontNext = storagePool.getNode(front).next;
+            NodePtr backPrev = storagePool.getNode(back).prev;
+            storagePool.prefetchNode(frontNext); // start both loads now
+            storagePool.prefetchNode(backPrev);
+            if (visit(front, storagePool.getNode(front).data, frontPos, true))
+                return;
+            if (frontPos != backPos && visit(back, storagePool.getNode(back).data, backPos, false))
+                return;
+            front = frontNext;
+            back = backPrev;
+            frontPos++;
+            backPos--;
+        }
+    }
+
+    /***** findFirst *****/
+    /*-------------------------------------------------------------------------
+     Finds the first occurrence of a key, walking the list from both ends at once
+     (see walkFromBothEnds): a match found from the head is the first occurrence,
+     while a match found from the tail is kept until the two walks meet, in case
+     an earlier one exists.
+
+     Precondition: None
+     Post-condition: Returns the position of the first occurrence and stores its
+     node in node, or returns -1 (node is then NULL_VALUE)
+     -------------------------------------------------------------------------*/
+    template <typename Key>
+    constexpr int findFirst(const Key &key, NodePtr &node) const
+    {
+        int found = -1; // position of the first occurrence seen so far
+        node = NULL_VALUE;
+        walkFromBothEnds([&key, &found, &node](NodePtr ptr, const ElementType &data, int pos, bool fromHead)
+                         {
+                             // Compare current node's data with the search target
+                             if (matches(data, key))
+                             {
+                                 found = pos; // the tail walk finds smaller positions each time
+                                 node = ptr;
+                                 return fromHead; // from the head, nothing can come earlier
+                             }
+                             return false; });
+        return found;
+    }
+
+    /***** moveAfter *****/
+    /*-------------------------------------------------------------------------
+     Moves node right after pred (to the head if pred == NULL_VALUE), relinking
+     only the indices around it; its access count follows it.
+
+     Precondition: node is in the list and pred is in the list or NULL_VALUE
+     Post-condition: pred -> node
+     -------------------------------------------------------------------------*/
+    constexpr void moveAfter(NodePtr node, NodePtr pred)
+    {
+        unsigned count = 0;
+        if constexpr (CountAccesses)
+            count = accessCount[node];
+        unlink(node);
+        linkBetween(node, pred, pred == NULL_VALUE ? first : storagePool.getNode(pred).next);
+        if constexpr (CountAccesses)
+            accessCount[node] = count;
+    }
+
+    /***** reorderFound *****/
+    /*-------------------------------------------------------------------------
+     Applies the reorder policy to a node that a lookup just found:
+     MOVE_TO_FRONT moves it to the head, TRANSPOSE swaps it with its predecessor,
+     and COUNT_ORDER counts the access and moves the node before the nodes
+     accessed fewer times (the list stays sorted by decreasing access counts).
+
+     Precondition: node is in the list
+     Post-condition: The list holds the same elements, maybe in another order
+     -------------------------------------------------------------------------*/
+    constexpr void reorderFound(NodePtr node)
+    {
+        NodePtr pred = storagePool.getNode(node).prev;
+        if (reorderPolicy == MOVE_TO_FRONT)
+        {
+            if (pred != NULL_VALUE)
+                moveAfter(node, NULL_VALUE);
+        }
+        else if (reorderPolicy == TRANSPOSE)
+        {
+            if (pred != NULL_VALUE)
+                moveAfter(node, storagePool.getNode(pred).prev);
+        }
+        else if (reorderPolicy == COUNT_ORDER)
+        {
+            if constexpr (CountAccesses) // setReorderPolicy refuses COUNT_ORDER otherwise
+            {
+                accessCount[node]++;
+                // Walk back over the nodes accessed fewer times (at most the hops of the lookup)
+                NodePtr target = pred;
+                while (target != NULL_VALUE && accessCount[target] < accessCount[node])
+                    target = storagePool.getNode(target).prev;
+                if (target != pred)
+                    moveAfter(node, target);
+            }
+        }
+    }
 
 public:
+    /***** Batch Edit *****/
+    /*------------------------------------------------------
+        One insertion or deletion for applyBatch. pos is a position in the list
+        as it was BEFORE the batch: an insertion at pos goes right before the
+        original element at pos (pos == size means at the tail), and a deletion
+        at pos removes the original element at pos. value is ignored for deletions.
+    -------------------------------------------------------*/
+    enum EditKind
+    {
+        INSERT_EDIT,
+        DELETE_EDIT
+    };
+
+    struct Edit
+    {
+        EditKind kind;     // insertion or deletion
+        unsigned pos;      // position in the original list
+        ElementType value; // element to insert
+    };
+
     /***** Constructor *****/
     /*------------------------------------------------------
         Creates an empty linked list by setting size to 0, first to NULL_VALUE,
         Meanwhile, storagePool is calling its copy constructor to initialize
-        a storage pool for the nodes forming the linked list
+        a storage pool for the nodes forming the linked list. Both take O(1),
+        whatever the capacity: a node gets its access count when it is linked.
 
         Precondition: None
         Post-condition: Empty linked list, size is 0 and an initialized storage pool
     -------------------------------------------------------*/
-    ArrayBasedList() : first(NULL_VALUE), size(0) {}
+    constexpr ArrayBasedList()
+        : first(NULL_VALUE), last(NULL_VALUE), size(0), reorderPolicy(NO_REORDER)
+    {
+        if constexpr (CountAccesses)
+        {
+            if (is_constant_evaluated())
+                fill(accessCount, accessCount + Capacity, 0u); // a constant cannot hold indeterminate values
+        }
+    }
+
+    /***** Constructor (memory resource) *****/
+    /*------------------------------------------------------
+        Creates an empty linked list whose storage pool builds allocator-aware
+        elements with resource. With a monotonic_buffer_resource, for example, the
+        elements allocate from one arena, and releasing the arena frees all of them
+        at once. Copies of the list use the global heap, like pmr containers do.
+
+        Precondition: resource must outlive the list
+        Post-condition: Empty linked list whose elements allocate from resource
+    -------------------------------------------------------*/
+    explicit ArrayBasedList(pmr::memory_resource *resource)
+        : storagePool(resource), first(NULL_VALUE), last(NULL_VALUE), size(0),
+          reorderPolicy(NO_REORDER) {}
 
     /***** Copy Constructor *****/
     /*--------------------------------------------------------------------
@@ -79,12 +494,32 @@ public:
     Post-condition: This list will contain an identical sequence of elements,
     using a separate storage pool,
     -----------------------------------------------------------------*/
-    ArrayBasedList(const ArrayBasedList<ElementType> &origList)
+    constexpr ArrayBasedList(const ArrayBasedList &origList)
+        : reorderPolicy(origList.reorderPolicy)
     {
+        if constexpr (CountAccesses)
+        {
+            if (is_constant_evaluated())
+                fill(accessCount, accessCount + Capacity, 0u); // a constant cannot hold indeterminate values
+        }
+
+        // Trivially copyable elements: clone the storage pool as one block
+        if constexpr (is_trivially_copyable<ElementType>::value)
+        {
+            storagePool.cloneFrom(origList.storagePool);
+            first = origList.first;
+            last = origList.last;
+            size = origList.size;
+            if constexpr (CountAccesses)
+                copy(origList.accessCount, origList.accessCount + storagePool.getHighWater(), accessCount);
+            return;
+        }
+        storagePool.setPolicy(origList.storagePool.getPolicy()); // same allocation policy
         // If the original list is empty, initialize this list as empty too
         if (origList.first == NULL_VALUE)
         {
             first = NULL_VALUE; // No head node
+            last = NULL_VALUE;  // No tail node
             size = 0;           // Size is zero
             return;
         }
@@ -100,6 +535,9 @@ public:
             storagePool.getNode(nextIndex).data = origList.storagePool.getNode(ptr).data;
             // Set the new node's next to NULL_VALUE (will be fixed if another node follows)
             storagePool.getNode(nextIndex).next = NULL_VALUE;
+            storagePool.getNode(nextIndex).prev = last; // the previously copied node
+            if constexpr (CountAccesses)
+                accessCount[nextIndex] = origList.accessCount[ptr];
 
             if (last == NULL_VALUE)
             {                      // To make sure it is the first node
@@ -115,6 +553,8 @@ public:
             ptr = origList.storagePool.getNode(ptr).next; // move ptr to the next node
                                                           // to be copied
         }
+        this->last = last; // the last copied node is the tail
+        storagePool.separateGenerations(origList.storagePool); // no handle of origList is valid here
     }
 
     /***** Assignment Operator *****/
@@ -126,27 +566,34 @@ public:
     Post-condition: This list will contain the same elements
     as rightHandSide.
     -------------------------------------------------------------------------------------*/
-    ArrayBasedList &operator=(const ArrayBasedList<ElementType> &rightHandSide)
+    constexpr ArrayBasedList &operator=(const ArrayBasedList &rightHandSide)
     {
         // If the object is being assigned to itself, do nothing
         if (this == &rightHandSide)
         {
             return *this;
         }
-        // Clear the current list
-        while (first != NULL_VALUE)
+        // Trivially copyable elements: the storage pool is overwritten as one block,
+        // so there is no need to free the current nodes one by one
+        reorderPolicy = rightHandSide.reorderPolicy;
+        if constexpr (is_trivially_copyable<ElementType>::value)
         {
-            NodePtr temp = first;                    // store the head in a temporary variable
-            first = storagePool.getNode(first).next; // move the head forward
-            storagePool.returnNode(temp);            // free the node
+            storagePool.cloneFrom(rightHandSide.storagePool);
+            first = rightHandSide.first;
+            last = rightHandSide.last;
+            size = rightHandSide.size;
+            if constexpr (CountAccesses)
+                copy(rightHandSide.accessCount, rightHandSide.accessCount + storagePool.getHighWater(), accessCount);
+            return *this;
         }
-
-        size = 0; // reset size after clearing the list to ensure an accurate fresh start
+        clear(); // every node of the pool is free again, in O(1)
+        storagePool.setPolicy(rightHandSide.storagePool.getPolicy()); // same allocation policy
 
         // If rightHandSide is empty, set this list to empty
         if (rightHandSide.first == NULL_VALUE)
         {
             first = NULL_VALUE;
+            this->last = NULL_VALUE;
             return *this;
         }
 
@@ -160,6 +607,9 @@ public:
             // now same operation as the copy constructor
             storagePool.getNode(nextIndex).data = rightHandSide.storagePool.getNode(ptr).data;
             storagePool.getNode(nextIndex).next = NULL_VALUE;
+            storagePool.getNode(nextIndex).prev = last;
+            if constexpr (CountAccesses)
+                accessCount[nextIndex] = rightHandSide.accessCount[ptr];
 
             if (last == NULL_VALUE)
             {
@@ -173,27 +623,42 @@ public:
             last = nextIndex;
             ptr = rightHandSide.storagePool.getNode(ptr).next;
         }
+        this->last = last; // the last copied node is the tail
+        storagePool.separateGenerations(rightHandSide.storagePool); // no handle of rightHandSide is valid here
 
         return *this; // return reference
     }
     /***** Destructor *****/
     /*--------------------------------------------------------------------------
      Destroys and cleans up the memory taken by the list by freeing up all the nodes
+     (at once, see clear); the storage pool then destroys the elements it built.
 
     Precondition: list and storage pool must be initialized
-    Post-condition: All nodes that belonged to the list are returned to the free list
-    in the NodePool, first is set to NULL_VALUE and size is set to zero
+    Post-condition: All nodes that belonged to the list are free in the NodePool,
+    first is set to NULL_VALUE and size is set to zero
     ------------------------------------------------------------------------------*/
-    ~ArrayBasedList()
+    constexpr ~ArrayBasedList()
     {
-        size = 0; // Reset size
-        // Traversal of list till the end
-        while (first != NULL_VALUE)
-        {
-            NodePtr temp = first;                    // Store current node index
-            first = storagePool.getNode(first).next; // Advance to the next node
-            storagePool.returnNode(temp);            // Free up the current node
-        }
+        clear();
+    }
+
+    /***** clear *****/
+    /*--------------------------------------------------------------------------
+     Removes every element in O(1), whatever the size of the list: the storage
+     pool is reset instead of freeing the nodes one by one. The elements are not
+     destroyed but overwritten when their nodes are reused (or destroyed with the
+     pool), and every handle to the list becomes stale. A list can thus be
+     cleared and refilled many times at the cost of the elements inserted only.
+
+    Precondition: None
+    Post-condition: The list is empty and every node of the storage pool is free
+    ------------------------------------------------------------------------------*/
+    constexpr void clear()
+    {
+        storagePool.reset();
+        first = NULL_VALUE;
+        last = NULL_VALUE;
+        size = 0;
     }
 
     /***** Getters *****/
@@ -208,26 +673,61 @@ public:
     as it will be commented out.
     -----------------------------------------------------------------------*/
 
-    int getsize() const
+    constexpr int getsize() const
     {
         return size;
     }
 
-    int getFirst() const
+    constexpr int getFirst() const
     {
         return first;
     }
 
-    int getFree() const
+    constexpr int getLast() const
+    {
+        return last;
+    }
+
+    constexpr int getFree() const
     {
         return storagePool.getFree();
     }
 
-    bool isEmpty() const
+    constexpr bool isEmpty() const
     {
         return first == NULL_VALUE;
     }
 
+    pmr::memory_resource *getResource() const
+    {
+        return storagePool.getResource();
+    }
+
+    constexpr AllocationPolicy getAllocationPolicy() const
+    {
+        return storagePool.getPolicy();
+    }
+
+    constexpr void setAllocationPolicy(AllocationPolicy policy)
+    {
+        storagePool.setPolicy(policy);
+    }
+
+    constexpr ReorderPolicy getReorderPolicy() const
+    {
+        return reorderPolicy;
+    }
+
+    constexpr void setReorderPolicy(ReorderPolicy policy)
+    {
+        if (policy == COUNT_ORDER && !CountAccesses)
+        {
+            report("COUNT_ORDER needs a list that counts accesses (CountAccesses = true)");
+            return; // the policy is unchanged
+        }
+        reorderPolicy = policy;
+    }
+
     /***** insertFirst *****/
     /*-------------------------------------------------------------------------------
     Inserts a new element at the beginning (head) of the list.
@@ -235,24 +735,26 @@ public:
     Post-condition: A new node is inserted at head of the list, size is incremented
     by 1, and first is updated to contain the index of the next node
     If the pool is full , a message is displayed
+    Returns a handle to the new node, or NULL_HANDLE if nothing was inserted
+    (like every insertion operation; the handle may be ignored)
     ----------------------------------------------------------------------------------*/
-    void insertFirst(const ElementType &element)
+    constexpr NodeHandle insertFirst(const ElementType &element)
     {
         // Checks if storage pool is full
         if (storagePool.isFull())
         {
-            cout << "Storage Pool is full; " << element << " could not be inserted" << endl;
-            return;
+            report("Storage Pool is full; ", element, " could not be inserted");
+            return NULL_HANDLE;
         }
         NodePtr nextIndex = storagePool.newNode(); // Allocate a new node from this list's pool
         // Set the new node's data to the element
         storagePool.getNode(nextIndex).data = element;
-        // Link the new node to point to the current first node
-        storagePool.getNode(nextIndex).next = first;
-        first = nextIndex; // update head
-        size++;            // increment size
+        // Link the new node before the current first node, and update head
+        linkBetween(nextIndex, NULL_VALUE, first);
+        size++; // increment size
         // display success
-        cout << element << " is inserted at the head of the list" << endl;
+        report(element, " is inserted at the head of the list");
+        return storagePool.makeHandle(nextIndex);
     }
 
     /***** insertLast *****/
@@ -261,88 +763,110 @@ public:
 
      Precondition: The storage pool must be not full
      Post-condition: If the list is empty, the element is inserted at the head.
-     Otherwise, it is inserted at the tail. The list size is incremented
+     Otherwise, it is inserted at the tail (in O(1), after last). The list size is incremented
      ---------------------------------------------------------------------------------------*/
-    void insertLast(const ElementType &element)
+    constexpr NodeHandle insertLast(const ElementType &element)
     {
         // Checks if storage pool is full
         if (storagePool.isFull())
         {
-            cout << "Storage Pool is full; " << element << " could not be inserted" << endl;
-            return;
+            report("Storage Pool is full; ", element, " could not be inserted");
+            return NULL_HANDLE;
         }
         // Checks if position is 0
         if (size == 0)
         {
             // inserting at head to avoid duplicate code by calling insertFirst
-            insertFirst(element);
-            return;
+            return insertFirst(element);
         }
 
-        NodePtr ptr = first; // Starts from head
-        // Traversal to the tail
-        while (storagePool.getNode(ptr).next != NULL_VALUE)
-        {
-            ptr = storagePool.getNode(ptr).next; // Move to next node
-        }
         // Allocate a new free node
         NodePtr nextIndex = storagePool.newNode();
-        storagePool.getNode(nextIndex).data = element;                       /// Set value
-        storagePool.getNode(nextIndex).next = storagePool.getNode(ptr).next; // New tail
-        // Link the previous tail to the new node
-        storagePool.getNode(ptr).next = nextIndex;
+        storagePool.getNode(nextIndex).data = element; /// Set value
+        // Link the previous tail to the new node, which becomes the new tail
+        linkBetween(nextIndex, last, NULL_VALUE);
         size++; // Increment size
         // display success
-        cout << element << " is inserted at the tail of the list" << endl;
+        report(element, " is inserted at the tail of the list");
+        return storagePool.makeHandle(nextIndex);
     }
 
     /***** insertAtPos *****/
     /*-------------------------------------------------------------------------------
-    Inserts a new element at a specific position in the list (after position - 1)
+    Inserts a new element at a specific position in the list (after position - 1).
+    The position is reached with a single cursor (see nodeAt), without prefetching.
 
     Precondition: Position must be in the range [0, size] and pool should not be full
     Post-condition: The element is inserted at the specified position, and the size is
     incremented. If the position is invalid, the insertion is aborted with an error message
     -----------------------------------------------------------------------------------*/
-    void insertAtPos(const ElementType &element, unsigned pos)
+    constexpr NodeHandle insertAtPos(const ElementType &element, unsigned pos)
     {
         // Checks if storage pool is full
         if (storagePool.isFull())
         {
-            cout << "Storage Pool is full; " << element << " could not be inserted" << endl;
-            return;
+            report("Storage Pool is full; ", element, " could not be inserted");
+            return NULL_HANDLE;
         }
         // Check if the position is valid
         if (pos > size)
         {
-            cout << "Invalid Position." << endl;
-            return;
+            report("Invalid Position.");
+            return NULL_HANDLE;
         }
         // Checks if position is 0
         if (pos == 0)
         {
             // inserting at head to avoid duplicate code by calling insertFirst
-            insertFirst(element);
-            return;
+            return insertFirst(element);
         }
 
-        NodePtr ptr = first; // Starts from head
-        unsigned count = 0;  // position counter
-
-        // loop to advance to the node at position 'pos - 1'
-        while (ptr != NULL_VALUE && count < pos - 1)
-        {
-            ptr = storagePool.getNode(ptr).next; // advance to next node
-            count++;                             // increasing count
-        }
+        NodePtr ptr = nodeAt(pos - 1); // the node at position 'pos - 1'
 
         NodePtr nextIndex = storagePool.newNode();     // Allocate a new node from this list's pool
         storagePool.getNode(nextIndex).data = element; // Set data
-        // Point to what ptr was pointing to
-        storagePool.getNode(nextIndex).next = storagePool.getNode(ptr).next;
-        storagePool.getNode(ptr).next = nextIndex;                     // Link ptr to new node
+        // Link ptr to new node, which points to what ptr was pointing to
+        linkBetween(nextIndex, ptr, storagePool.getNode(ptr).next);
         size++;                                                        // update size
-        cout << element << " is inserted at position " << pos << endl; // display success
+        report(element, " is inserted at position ", pos); // display success
+        return storagePool.makeHandle(nextIndex);
+    }
+
+    /***** appendAll *****/
+    /*-------------------------------------------------------------------------------------
+     Inserts several elements at the tail of the list, in their order. The nodes are taken as one run of contiguous nodes of the
+     storage pool when there is one, so the new part of the list is contiguous in memory;
+     otherwise they are taken one by one.
+
+     Precondition: The storage pool must have at least items.size() free nodes
+     Post-condition: The elements are inserted at the tail and the size is increased.
+     If the pool does not have enough free nodes, nothing is inserted and an error
+     message is displayed. Returns the number of inserted elements.
+     ---------------------------------------------------------------------------------------*/
+    constexpr int appendAll(const vector<ElementType> &items)
+    {
+        int count = (int)items.size();
+        if (count == 0)
+            return 0;
+        // Checks if storage pool has enough free nodes
+        if (count > storagePool.countFree())
+        {
+            report("Storage Pool is full; the ", count, " elements could not be inserted");
+            return 0;
+        }
+
+        NodePtr tail = last; // NULL_VALUE if the list is empty
+        NodePtr run = storagePool.allocateRun(count); // contiguous nodes, if possible
+        for (int i = 0; i < count; i++)
+        {
+            NodePtr nextIndex = (run != NULL_VALUE) ? run + i : storagePool.newNode();
+            storagePool.getNode(nextIndex).data = items[i];
+            linkBetween(nextIndex, tail, NULL_VALUE); // new tail
+            tail = nextIndex;
+        }
+        size += count;
+        report(count, " elements are inserted at the tail of the list");
+        return count;
     }
 
     /***** insertAfter *****/
@@ -354,20 +878,29 @@ public:
     Post-condition: A new node with the given element is inserted immediately after
     the first occurrence of after. If the list is empty, or after is not found, no changes
     are made. If the pool is full, the insertion is aborted with an error message.
+    after may be a key of another type when KeyEqual is transparent. The node of after
+    is reordered as by search (see setReorderPolicy) before the insertion.
     ---------------------------------------------------------------------------------*/
-    void insertAfter(const ElementType &element, const ElementType &after)
+    constexpr NodeHandle insertAfter(const ElementType &element, const ElementType &after)
+    {
+        return insertAfter<ElementType>(element, after);
+    }
+
+    template <typename Key>
+        requires(TRANSPARENT_KEYS || is_same_v<Key, ElementType>)
+    constexpr NodeHandle insertAfter(const ElementType &element, const Key &after)
     {
         // List is empty so no insertion possible
         if (first == NULL_VALUE)
         {
-            cout << "List is empty" << endl;
-            return;
+            report("List is empty");
+            return NULL_HANDLE;
         }
         // Checks if storage pool is full
         if (storagePool.isFull())
         {
-            cout << "Storage Pool is full; " << element << " could not be inserted" << endl;
-            return;
+            report("Storage Pool is full; ", element, " could not be inserted");
+            return NULL_HANDLE;
         }
 
         NodePtr ptr = first; // Start from head
@@ -375,25 +908,25 @@ public:
         while (ptr != NULL_VALUE)
         {
             // Compare current node's data with after
-            if (storagePool.getNode(ptr).data == after)
+            if (matches(storagePool.getNode(ptr).data, after))
             {
+                reorderFound(ptr); // after was looked up: apply the reorder policy
                 // Allocate a new node from this list's pool
                 NodePtr nextIndex = storagePool.newNode();
                 // Set the new node's data
                 storagePool.getNode(nextIndex).data = element;
-                // Link the new node to the successor of after
-                storagePool.getNode(nextIndex).next = storagePool.getNode(ptr).next;
-                // Link the 'after' node to the new node
-                storagePool.getNode(ptr).next = nextIndex;
+                // Link the new node between the 'after' node and its successor
+                linkBetween(nextIndex, ptr, storagePool.getNode(ptr).next);
                 // Increment size
                 size++;
                 // display success
-                cout << element << " is inserted after " << after << "." << endl;
-                return;
+                report(element, " is inserted after ", after, ".");
+                return storagePool.makeHandle(nextIndex);
             }
             ptr = storagePool.getNode(ptr).next; // move forward
         }
-        cout << after << " not found :(" << endl; // element not found
+        report(after, " not found :("); // element not found
+        return NULL_HANDLE;
     }
 
     /***** deleteFirst *****/
@@ -406,19 +939,19 @@ public:
      an error message. First is updated
     -----------------------------------------------------------------------------*/
 
-    void deleteFirst()
+    constexpr void deleteFirst()
     {
         // Checks whether list is empty
         if (first == NULL_VALUE)
         {
-            cout << "The list is empty. Nothing can be deleted." << endl;
+            report("The list is empty. Nothing can be deleted.");
             return;
         }
-        NodePtr ptr = first;                     // Starts from head
-        first = storagePool.getNode(first).next; // Sets first to next node
-        storagePool.returnNode(ptr);             // returns the node to the free list
-        size--;                                  // decrement size
-        cout << " The head of the list is successfully deleted from the list." << endl;
+        NodePtr ptr = first;         // Starts from head
+        unlink(ptr);                 // Sets first to next node
+        storagePool.returnNode(ptr); // returns the node to the free list
+        size--;                      // decrement size
+        report(" The head of the list is successfully deleted from the list.");
     }
 
     /***** deleteLast *****/
@@ -426,47 +959,31 @@ public:
     Removes the tail from the list.
 
     Precondition: The list may not be empty
-    Post-condition: The last node is removed and set as free. The size is decremented
-    by 1. And, if the list becomes empty first is updated to NULL_VALUE.
-    The deletion is aborted with an error message.
+    Post-condition: The last node is removed (in O(1), from last and its prev index)
+    and set as free. The size is decremented by 1. And, if the list becomes empty
+    first is updated to NULL_VALUE. The deletion is aborted with an error message.
     ------------------------------------------------------------------------------*/
 
-    void deleteLast()
+    constexpr void deleteLast()
     {
         // Checks whether the list is empty
         if (first == NULL_VALUE)
         {
-            cout << "List is empty. Nothing to delete." << endl;
+            report("List is empty. Nothing to delete.");
             return;
         }
 
-        NodePtr ptr = first;       // start from beginning
-        NodePtr pred = NULL_VALUE; // this is to check the previous node
-        // Traverse to the end of the list
-        while (storagePool.getNode(ptr).next != NULL_VALUE)
-        {
-            pred = ptr;                          // move pred forward
-            ptr = storagePool.getNode(ptr).next; // move ptr forward
-        }
-        // this means that the element we want to delete is the only element in the list
-        if (pred == NULL_VALUE)
-        {
-            first = NULL_VALUE; // we set first to NULL_VALUE (list is empty)
-        }
-        else
-        {
-            storagePool.getNode(pred).next = NULL_VALUE; // the previous node is linked
-                                                         // to NULL_VALUE
-        }
-
+        NodePtr ptr = last; // the tail
+        unlink(ptr);        // its predecessor becomes the tail (or the list becomes empty)
         storagePool.returnNode(ptr); // the deleted node is set as free
         size--;                      // size is decremented
-        cout << "The tail of the list was successfully deleted." << endl;
+        report("The tail of the list was successfully deleted.");
     }
 
     /***** deleteAtPos *****/
     /*-------------------------------------------------------------------------------
-    Deletes the element at a specified position from the list.
+    Deletes the element at a specified position from the list. The position is
+    reached with a single cursor (see nodeAt), without prefetching.
 
     Precondition: The list must not be empty and position must be
     in the range [0, size - 1].
@@ -474,18 +991,18 @@ public:
     first free node. The size is decremented by 1.The deletion is aborted with
     an error message.
     -------------------------------------------------------------------------------*/
-    void deleteAtPos(unsigned int pos)
+    constexpr void deleteAtPos(unsigned int pos)
     {
         // Check is list is empty
         if (first == NULL_VALUE)
         {
-            cout << "The list is empty. Nothing can be deleted" << endl;
+            report("The list is empty. Nothing can be deleted");
             return;
         }
         // Checks if position out of bounds
         if (pos >= size)
         {
-            cout << "Invalid Position." << endl;
+            report("Invalid Position.");
             return;
         }
 
@@ -493,28 +1010,19 @@ public:
         // Delete the first element
         if (pos == 0)
         {
-            first = storagePool.getNode(ptr).next; // update first
-            storagePool.returnNode(ptr);           // return the first node to the free list
+            unlink(ptr);                 // update first
+            storagePool.returnNode(ptr); // return the first node to the free list
         }
         else
         {
-            NodePtr pred = NULL_VALUE; // to store the precedent node
-            int count = 0;             // position counter
-
-            // Traverse to node at position 'pos'
-            while (ptr != NULL_VALUE && count < pos)
-            {
-                pred = ptr;                          // move pred forward
-                ptr = storagePool.getNode(ptr).next; // move ptr forward
-                count++;                             // increment count
-            }
+            ptr = nodeAt(pos); // the node at position 'pos'
             // linking he previous node to the next node (in relation to the node
             // we want to delete)
-            storagePool.getNode(pred).next = storagePool.getNode(ptr).next;
+            unlink(ptr);
             storagePool.returnNode(ptr); // set the deleted node to free
         }
         size--; // decrement size
-        cout << "Element at position " << pos << " is deleted." << endl;
+        report("Element at position ", pos, " is deleted.");
     }
 
     /***** deleteElement ****/
@@ -524,71 +1032,408 @@ public:
     Precondition: The list need contain the element and cannot be empty.
     Post-condition: The element's node is removed from the list and set to the
     first free node. The size is decremented by 1 and the deletion is aborted with
-    an error message.
+    an error message. element may be a key of another type when KeyEqual is transparent.
     ----------------------------------------------------------------------------------*/
-    void deleteElement(const ElementType &element)
+    constexpr void deleteElement(const ElementType &element)
+    {
+        deleteElement<ElementType>(element);
+    }
+
+    template <typename Key>
+        requires(TRANSPARENT_KEYS || is_same_v<Key, ElementType>)
+    constexpr void deleteElement(const Key &element)
     {
         // Checks if list is empty
         if (first == NULL_VALUE)
         {
-            cout << "The list is empty." << endl;
+            report("The list is empty.");
             return;
         }
-        NodePtr ptr = first;       // Start from head of the list
-        NodePtr pred = NULL_VALUE; // Pointer to previous node(null at first)
+        NodePtr ptr = first; // Start from head of the list
         // Traverse till the eend
         while (ptr != NULL_VALUE)
         {
             // Compare the node data to the element
-            if (storagePool.getNode(ptr).data == element)
+            if (matches(storagePool.getNode(ptr).data, element))
+            {
+                // link the previous with the next (or move first if ptr is the head)
+                unlink(ptr);
+                storagePool.returnNode(ptr); // the node is set as the first free node
+                size--;                      // size is decremented
+                report(element, " is deleted.");
+                return;
+            }
+            ptr = storagePool.getNode(ptr).next; // ptr is moved forward
+        }
+        report(element, " is not found");
+    }
+
+    /***** isValid *****/
+    /*--------------------------------------------------------------------------------
+    Checks whether a handle returned by an insertion still refers to a node of
+    the list, that is, the node was not deleted (and maybe reused) since.
+
+    Precondition: handle was returned by this list (a handle of another list
+    is not recognized as such: it may happen to be valid here)
+    Post-condition: Returns true if the handle can be used
+    ----------------------------------------------------------------------------------*/
+    constexpr bool isValid(NodeHandle handle) const
+    {
+        return storagePool.isCurrent(handle);
+    }
+
+    /***** erase *****/
+    /*--------------------------------------------------------------------------------
+    Deletes the node referred to by a handle in O(1), without searching the list.
+
+    Precondition: handle was returned by an insertion into this list
+    Post-condition: The node is removed and freed, and every handle to it becomes
+    stale. If the handle is stale, nothing is changed, an error message is
+    displayed and false is returned.
+    ----------------------------------------------------------------------------------*/
+    constexpr bool erase(NodeHandle handle)
+    {
+        if (!storagePool.isCurrent(handle))
+        {
+            report("Invalid or stale handle.");
+            return false;
+        }
+        report(storagePool.getNode(handle.index).data, " is deleted.");
+        unlink(handle.index);                 // link its predecessor and successor
+        storagePool.returnNode(handle.index); // the node is set as the first free node
+        size--;                               // size is decremented
+        return true;
+    }
+
+    /***** insertAfter (handle) *****/
+    /*--------------------------------------------------------------------------------
+    Inserts a new element right after the node referred to by a handle, in O(1).
+
+    Precondition: after was returned by an insertion into this list, and the
+    storage pool must not be full
+    Post-condition: Returns a handle to the new node. If after is stale or the pool
+    is full, nothing is inserted, an error message is displayed and NULL_HANDLE is returned.
+    ----------------------------------------------------------------------------------*/
+    constexpr NodeHandle insertAfter(const ElementType &element, NodeHandle after)
+    {
+        if (!storagePool.isCurrent(after))
+        {
+            report("Invalid or stale handle.");
+            return NULL_HANDLE;
+        }
+        // Checks if storage pool is full
+        if (storagePool.isFull())
+        {
+            report("Storage Pool is full; ", element, " could not be inserted");
+            return NULL_HANDLE;
+        }
+        NodePtr nextIndex = storagePool.newNode();     // Allocate a new node
+        storagePool.getNode(nextIndex).data = element; // Set data
+        linkBetween(nextIndex, after.index, storagePool.getNode(after.index).next);
+        size++;
+        report(element, " is inserted after ", storagePool.getNode(after.index).data, ".");
+        return storagePool.makeHandle(nextIndex);
+    }
+
+    /***** update *****/
+    /*--------------------------------------------------------------------------------
+    Replaces, in place and in O(1), the element of the node referred to by a handle.
+
+    Precondition: handle was returned by an insertion into this list
+    Post-condition: The node holds element and the handle stays valid. If the handle
+    is stale, nothing is changed, an error message is displayed and false is returned.
+    ----------------------------------------------------------------------------------*/
+    constexpr bool update(NodeHandle handle, const ElementType &element)
+    {
+        if (!storagePool.isCurrent(handle))
+        {
+            report("Invalid or stale handle.");
+            return false;
+        }
+        storagePool.getNode(handle.index).data = element;
+        report("Element is updated to ", element, ".");
+        return true;
+    }
+
+    /***** applyBatch *****/
+    /*--------------------------------------------------------------------------------
+    Applies several positional insertions and deletions in one traversal of the list,
+    instead of one traversal per change. All positions refer to the list before the
+    batch. Insertions at the same position keep the order in which they are given.
+    The deleted nodes are returned to the storage pool with one splice, BEFORE the
+    insertions, so the insertions can reuse them: a batch that deletes as many
+    elements as it inserts always fits, even in a full pool.
+
+    Precondition: Insert positions are in [0, size], delete positions are in
+    [0, size - 1] and distinct, and the insertions do not outnumber the free nodes
+    plus the deletions
+    Post-condition: Every edit is applied and true is returned. If the batch is
+    invalid, nothing is changed, an error message is displayed and false is returned.
+    ----------------------------------------------------------------------------------*/
+    bool applyBatch(const vector<Edit> &edits)
+    {
+        // Validate the whole batch before changing anything
+        vector<bool> deleted(size, false); // original positions deleted by the batch
+        vector<const Edit *> insertions;
+        for (const Edit &edit : edits)
+        {
+            if (edit.kind == INSERT_EDIT)
             {
-                // if pred is null, it means that the element is at head
-                if (pred == NULL_VALUE)
+                if (edit.pos > (unsigned)size)
                 {
-                    // so we set first to the next node
-                    first = storagePool.getNode(ptr).next;
+                    report("Invalid Position ", edit.pos, " in batch.");
+                    return false;
                 }
-                else
+                insertions.push_back(&edit);
+            }
+            else
+            {
+                if (edit.pos >= (unsigned)size || deleted[edit.pos])
                 {
-                    // else, we link the previous with the next
-                    storagePool.getNode(pred).next = storagePool.getNode(ptr).next;
+                    report("Invalid Position ", edit.pos, " in batch.");
+                    return false;
                 }
+                deleted[edit.pos] = true;
+            }
+        }
+        int deletions = (int)edits.size() - (int)insertions.size();
+        if ((int)insertions.size() - deletions > Capacity - size)
+        {
+            report("Storage Pool is full; the batch could not be applied");
+            return false;
+        }
 
-                storagePool.returnNode(ptr); // the node is set as the first free node
-                size--;                      // size is decremented
-                cout << element << " is deleted." << endl;
-                return;
+        // First pass: unlink the deleted elements, and keep the original order
+        // of the others (original[pos], or NULL_VALUE if deleted)
+        vector<NodePtr> original(size, NULL_VALUE);
+        NodePtr removedHead = NULL_VALUE; // chain of deleted nodes
+        NodePtr removedTail = NULL_VALUE;
+        NodePtr ptr = first;
+        for (int pos = 0; pos < size; pos++)
+        {
+            NodePtr next = storagePool.getNode(ptr).next; // save next node
+            if (deleted[pos])
+            {
+                unlink(ptr);
+                if (removedTail == NULL_VALUE)
+                    removedHead = ptr;
+                else
+                    storagePool.getNode(removedTail).next = ptr;
+                removedTail = ptr;
             }
-            pred = ptr;                          // pred is moved forward
-            ptr = storagePool.getNode(ptr).next; // ptr is moved forward
+            else
+            {
+                original[pos] = ptr;
+            }
+            ptr = next; // move forward
+        }
+        // All the deleted nodes go back to the free list at once
+        if (removedHead != NULL_VALUE)
+        {
+            storagePool.returnChain(removedHead, removedTail);
         }
-        cout << element << " is not found" << endl;
+
+        // Second pass: insert the new elements after the last node kept or
+        // inserted before their position; at the same position, in order
+        stable_sort(insertions.begin(), insertions.end(), [](const Edit *a, const Edit *b)
+                    { return a->pos < b->pos; });
+        NodePtr pred = NULL_VALUE; // last node of the new list
+        size_t e = 0;              // next insertion to apply
+        for (unsigned pos = 0; pos <= (unsigned)size && e < insertions.size(); pos++)
+        {
+            while (e < insertions.size() && insertions[e]->pos == pos)
+            {
+                NodePtr nextIndex = storagePool.newNode(); // may reuse a deleted node
+                storagePool.getNode(nextIndex).data = insertions[e]->value;
+                NodePtr succ = (pred == NULL_VALUE) ? first : storagePool.getNode(pred).next;
+                linkBetween(nextIndex, pred, succ); // before the next original element
+                pred = nextIndex;
+                e++;
+            }
+            if (pos < (unsigned)size && original[pos] != NULL_VALUE)
+                pred = original[pos]; // the original element is kept
+        }
+        size += (int)insertions.size() - deletions;
+        report("Batch applied: ", insertions.size(), " inserted, ", deletions, " deleted.");
+        return true;
+    }
+
+    /***** removeIf *****/
+    /*--------------------------------------------------------------------------------
+    Removes every element for which condition returns true, in one traversal.
+
+    Precondition: condition must be callable with a const ElementType&
+    Post-condition: No remaining element satisfies condition. Returns the number
+    of removed elements.
+    ----------------------------------------------------------------------------------*/
+    template <typename Predicate>
+    constexpr int removeIf(Predicate condition)
+    {
+        int removed = removeMatching(condition);
+        report(removed, " element(s) deleted.");
+        return removed;
+    }
+
+    /***** removeAll *****/
+    /*--------------------------------------------------------------------------------
+    Removes every occurrence of element, in one traversal.
+
+    Precondition: None (element may be a key of another type when KeyEqual is transparent)
+    Post-condition: element is no longer in the list. Returns the number of
+    removed occurrences.
+    ----------------------------------------------------------------------------------*/
+    constexpr int removeAll(const ElementType &element)
+    {
+        return removeAll<ElementType>(element);
+    }
+
+    template <typename Key>
+        requires(TRANSPARENT_KEYS || is_same_v<Key, ElementType>)
+    constexpr int removeAll(const Key &element)
+    {
+        int removed = removeMatching([&element](const ElementType &data)
+                                     { return matches(data, element); });
+        report(removed, " occurrence(s) of ", element, " deleted.");
+        return removed;
     }
 
     /***** Search *****/
     /*----------------------------------------------------------------------------
      Searches for the first occurrence of an element and returns its position.
+     The list is walked from both ends at once (see walkFromBothEnds). On a
+     list that is not const, a successful search then applies the reorder
+     policy (see setReorderPolicy), so the returned position is the one the
+     element had before it was moved.
 
-     Precondition: None
+     Precondition: None (element may be a key of another type when KeyEqual is transparent)
      Post-condition: If the element is found, returns its position.
      If not, returns -1
      ------------------------------------------------------------------------*/
-    int search(const ElementType &element) const
+    constexpr int search(const ElementType &element)
     {
-        NodePtr ptr = first; // start from head
-        int pos = 0;         // position counter set to 0
-        // Traversal of list till the end
-        while (ptr != NULL_VALUE)
+        return search<ElementType>(element);
+    }
+
+    template <typename Key>
+        requires(TRANSPARENT_KEYS || is_same_v<Key, ElementType>)
+    constexpr int search(const Key &element)
+    {
+        NodePtr node = NULL_VALUE;
+        int pos = findFirst(element, node);
+        if (node != NULL_VALUE)
+            reorderFound(node);
+        return pos;
+    }
+
+    // A const list is never reordered: same as searchNoReorder
+    constexpr int search(const ElementType &element) const
+    {
+        return searchNoReorder(element);
+    }
+
+    template <typename Key>
+        requires(TRANSPARENT_KEYS || is_same_v<Key, ElementType>)
+    constexpr int search(const Key &element) const
+    {
+        return searchNoReorder(element);
+    }
+
+    /***** searchNoReorder *****/
+    /*----------------------------------------------------------------------------
+     Same as search, but never reorders the list, whatever the reorder policy,
+     for callers that need the positions to stay stable.
+     ------------------------------------------------------------------------*/
+    constexpr int searchNoReorder(const ElementType &element) const
+    {
+        return searchNoReorder<ElementType>(element);
+    }
+
+    template <typename Key>
+        requires(TRANSPARENT_KEYS || is_same_v<Key, ElementType>)
+    constexpr int searchNoReorder(const Key &element) const
+    {
+        NodePtr node = NULL_VALUE;
+        return findFirst(element, node);
+    }
+
+    /***** searchMany *****/
+    /*----------------------------------------------------------------------------
+     Searches for several elements in one traversal of the list, instead of one
+     traversal per element. Every node is compared with all the keys not found
+     yet: directly when there are few keys, or through a small hash table of the
+     keys (when Hash can hash them) when there are many. The traversal stops as
+     soon as every key is found.
+
+     Precondition: None (the keys may be of another type when KeyEqual is transparent)
+     Post-condition: Returns, for every key, the position of its first occurrence
+     in the list, or -1 if it is not in the list
+     ------------------------------------------------------------------------*/
+    vector<int> searchMany(const vector<ElementType> &keys) const
+    {
+        return searchMany<ElementType>(keys);
+    }
+
+    template <typename Key>
+        requires(TRANSPARENT_KEYS || is_same_v<Key, ElementType>)
+    vector<int> searchMany(const vector<Key> &keys) const
+    {
+        int count = (int)keys.size();
+        vector<int> positions(count, -1);
+        vector<bool> settled(count, false); // found from the head: cannot change anymore
+        int remaining = count;
+        // Records that the node at pos holds keys[k]
+        auto record = [&](int k, int pos, bool fromHead)
+        {
+            if (settled[k])
+                return;
+            positions[k] = pos; // the tail walk finds smaller positions each time
+            if (fromHead)
+            {
+                settled[k] = true;
+                remaining--;
+            }
+        };
+
+        if constexpr (hashesKeys<Key>())
         {
-            // Compare current node's data with the search target
-            if (storagePool.getNode(ptr).data == element)
+            if (count > SMALL_KEY_SET)
             {
-                return pos; // if matches, return position
+                // Open-addressing table of the keys; equal keys take consecutive slots
+                // of the same probe sequence, so a lookup finds all of them
+                int slots = 1;
+                while (slots < 2 * count)
+                    slots *= 2;
+                vector<int> table(slots, -1); // key index, or -1 for an empty slot
+                Hash hasher;
+                for (int k = 0; k < count; k++)
+                {
+                    size_t slot = hasher(keys[k]) & (slots - 1);
+                    while (table[slot] != -1)
+                        slot = (slot + 1) & (slots - 1); // linear probing
+                    table[slot] = k;
+                }
+                walkFromBothEnds([&](NodePtr, const ElementType &data, int pos, bool fromHead)
+                                 {
+                                     for (size_t slot = hasher(data) & (slots - 1); table[slot] != -1;
+                                          slot = (slot + 1) & (slots - 1))
+                                     {
+                                         if (matches(data, keys[table[slot]]))
+                                             record(table[slot], pos, fromHead);
+                                     }
+                                     return remaining == 0; });
+                return positions;
             }
-            ptr = storagePool.getNode(ptr).next; // move forward to next node
-            pos++;                               // increment position
         }
-        return -1; // element not found
+        // Few keys (or no hash): compare every node with every key
+        walkFromBothEnds([&](NodePtr, const ElementType &data, int pos, bool fromHead)
+                         {
+                             for (int k = 0; k < count; k++)
+                             {
+                                 if (matches(data, keys[k]))
+                                     record(k, pos, fromHead);
+                             }
+                             return remaining == 0; });
+        return positions;
     }
 
     /***** reverse *****/
@@ -598,16 +1443,18 @@ public:
      Precondition: None
      Post-condition: Head becomes tails and evey node is now linked to is predecessor.
      --------------------------------------------------------------------------------*/
-    void reverse()
+    constexpr void reverse()
     {
         NodePtr pred = NULL_VALUE; // previous node
         NodePtr current = first;   // current node
         NodePtr next = NULL_VALUE; // to store next (to keep track of current)
+        last = first;              // the head becomes the tail
         // Traverse the list
         while (current != NULL_VALUE)
         {
             next = storagePool.getNode(current).next; // save next node
             storagePool.getNode(current).next = pred; // link current to previous
+            storagePool.getNode(current).prev = next; // and back to its old successor
             pred = current;                           // move previous forward
             current = next;                           // move current forward
         }
@@ -615,6 +1462,101 @@ public:
         first = pred; // set first to the last previous node (tail)
     }
 
+    /***** ReverseView *****/
+    /*-----------------------------------------------------------------------
+     A read-only view of the list from tail to head. It follows the prev index
+     of every node from the tail, so no "next" link is ever written and no buffer
+     is needed, whatever the size of the list. This allows several readers to
+     traverse a const list backwards at the same time.
+     The view must not outlive the list, and it is invalidated by any modification.
+     -----------------------------------------------------------------------*/
+    class ReverseView
+    {
+    private:
+        const ArrayBasedList *list; // the list being viewed
+
+    public:
+        /***** ReverseView::iterator *****/
+        /*-------------------------------------------------------------------
+         Walks the prev indices, giving access to the data of every node
+         from tail to head.
+         --------------------------------------------------------------------*/
+        class iterator
+        {
+        private:
+            const ArrayBasedList *list; // the list being iterated
+            NodePtr current;            // current node (NULL_VALUE: before the head)
+
+        public:
+            constexpr iterator(const ArrayBasedList *l, NodePtr c) : list(l), current(c) {}
+
+            constexpr const ElementType &operator*() const
+            {
+                return list->storagePool.getNode(current).data;
+            }
+
+            constexpr iterator &operator++()
+            {
+                current = list->storagePool.getNode(current).prev; // move towards the head
+                return *this;
+            }
+
+            constexpr bool operator!=(const iterator &other) const
+            {
+                return current != other.current;
+            }
+
+            constexpr bool operator==(const iterator &other) const
+            {
+                return current == other.current;
+            }
+        };
+
+        /***** ReverseView Constructor *****/
+        constexpr explicit ReverseView(const ArrayBasedList &l) : list(&l) {}
+
+        constexpr iterator begin() const
+        {
+            return iterator(list, list->last); // starts from the tail
+        }
+
+        constexpr iterator end() const
+        {
+            return iterator(list, NULL_VALUE); // one before the head
+        }
+    };
+
+    /***** forEachReverse *****/
+    /*-------------------------------------------------------------------------
+     Applies a function to every element of the list, from tail to head,
+     without modifying any link of the list: it follows the prev indices from
+     the tail, in O(1) extra memory.
+
+     Precondition: func must be callable with a const ElementType&
+     Post-condition: func was called once for every element, starting with the tail
+     -------------------------------------------------------------------------*/
+    template <typename Function>
+    constexpr void forEachReverse(Function func) const
+    {
+        for (NodePtr ptr = last; ptr != NULL_VALUE; ptr = storagePool.getNode(ptr).prev)
+        {
+            func(storagePool.getNode(ptr).data);
+        }
+    }
+
+    /***** reversed *****/
+    /*-------------------------------------------------------------------------
+     Returns a read-only view of the list that visits the elements from tail
+     to head, for example: for (const string &s : myList.reversed())
+
+     Precondition: None
+     Post-condition: The list is not modified
+     -------------------------------------------------------------------------*/
+    constexpr ReverseView reversed() const
+    {
+        return ReverseView(*this);
+    }
+
     /***** display *****/
     /*-------------------------------------------------------------------------
      Provide the outputs of the element of the linked list to the the output stream.
@@ -646,6 +1588,34 @@ public:
         out << endl; // End line
     }
 
+    /***** rdisplay *****/
+    /*-------------------------------------------------------------------------
+     Outputs the elements of the linked list from tail to head, without
+     reversing the list itself.
+
+     Precondition: ostream out must be valid
+     Post-condition: If list is empty, "NULL" is printed,
+     else, elements are printed from tail to head separated by " -> "
+     -----------------------------------------------------------------------------*/
+    void rdisplay(ostream &out) const
+    {
+        if (first == NULL_VALUE)
+        {
+            // List is empty
+            out << "NULL" << endl;
+            return;
+        }
+        bool isTail = true; // Only print " -> " before the elements after the tail
+        forEachReverse([&out, &isTail](const ElementType &data)
+                       {
+                           if (!isTail)
+                               out << " -> ";
+                           out << data; // print data
+                           isTail = false;
+                       });
+        out << endl; // End line
+    }
+
     /***** Overloaded Output Operator *****/
     /*---------------------------------------------------------------
     Allows the list to be output directly using the << stream operator,
@@ -656,7 +1626,7 @@ public:
     Post-condition: The elements of the list are sent to the output stream
     using the display() method.
     -----------------------------------------------------------------------*/
-    friend ostream &operator<<(ostream &out, const ArrayBasedList<ElementType> &list)
+    friend ostream &operator<<(ostream &out, const ArrayBasedList &list)
     {
         list.display(out); // call the display method
         return out;        // Return the output stream to allow 'cout<<list)'
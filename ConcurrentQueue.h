@@ -0,0 +1,360 @@
+#ifndef CONCURRENTQUEUE_H
+#define CONCURRENTQUEUE_H
+
+/**--ConcurrentQueue.h------------------------------------------------------------------------
+    This template class is a bounded, lock-free FIFO queue for several producer and several
+    consumer threads. Like NodePool, it stores its nodes in a fixed-size array and links them
+    with indices instead of pointers, so its memory footprint is fixed and it never calls the
+    general-purpose allocator after construction.
+
+    It follows the Michael-Scott queue: the queue is a singly linked list with a dummy node
+    at its head, producers append at the tail and consumers advance the head. The free nodes
+    form a lock-free stack (the free list of NodePool). Every link (head, tail, free and the
+    next index of every node) is a "tagged index": a 32-bit node index packed with a 32-bit
+    counter that is incremented on every change, so a compare-and-swap cannot succeed on a
+    link that was changed and then changed back (ABA problem).
+
+    Basic Operations:
+    Constructor: Creates an empty queue whose free list holds every node but the dummy
+    tryEnqueue: Appends an element; returns false when the queue is full (backpressure)
+    tryDequeue: Removes the oldest element; returns false when the queue is empty
+    enqueueBatch: Appends several elements, linking them to the queue with one CAS
+    dequeueBatch: Removes up to a given number of elements, claiming them with one CAS
+    capacity / isEmpty: Information about the queue
+
+    Class Invariants:
+    1. head points to the dummy node; the elements are in the nodes after it
+    2. tail points to the last node or, while an append is completing, to a node before
+    it that is still in the queue (a consumer advances tail before freeing its node)
+    3. Every node is either in the queue or in the free list
+
+    NOTE: ElementType must be trivially copyable. A consumer copies the element of the
+    next node before trying to claim it, and discards the copy when the claim fails, while
+    a producer may already be writing a new element in that node. So the element is not
+    stored as an ElementType but as an array of atomic words, written and read with relaxed
+    atomic operations: the copy may be torn, but there is no data race, and a copy is only
+    kept when the claim succeeds, which proves the node was not reused meanwhile.
+-------------------------------------------------------------------------------------------*/
+#include "NodePool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename ElementType, int Capacity = NUM_NODES> // Capacity: maximum number of elements
+class ConcurrentQueue
+{
+    static_assert(std::is_trivially_copyable<ElementType>::value,
+                  "ConcurrentQueue elements must be trivially copyable");
+    static_assert(Capacity > 0, "ConcurrentQueue capacity must be positive");
+
+private:
+    typedef uint64_t TaggedPtr; // node index (low 32 bits) and tag (high 32 bits)
+    typedef uint64_t Word;      // unit of the atomic copies of an element
+
+    static const int WORDS = (sizeof(ElementType) + sizeof(Word) - 1) / sizeof(Word);
+
+    /**--NodeType--------------------------------------------------
+     A node holds the bytes of an element, in atomic words, and the
+     tagged index of the next node (in the queue, or in the free list
+     when the node is free).
+     ---------------------------------------------------------------**/
+    struct NodeType
+    {
+        std::atomic<Word> data[WORDS]; // data stored in the node
+        std::atomic<TaggedPtr> next;   // tagged index of the next node
+    };
+
+    static const int POOL_SIZE = Capacity + 1; // one more node for the dummy
+
+    NodeType arrNode[POOL_SIZE];  // Array of nodes
+    // head, tail and free are each on their own cache line so producers,
+    // consumers and the free list do not slow each other down
+    alignas(64) std::atomic<TaggedPtr> head; // dummy node
+    alignas(64) std::atomic<TaggedPtr> tail; // last node (or the one before it)
+    alignas(64) std::atomic<TaggedPtr> free; // first free node
+
+    /***** Tagged Index Helpers *****/
+    static TaggedPtr pack(NodePtr index, uint32_t tag)
+    {
+        return (TaggedPtr(tag) << 32) | uint32_t(index);
+    }
+
+    static NodePtr indexOf(TaggedPtr ptr)
+    {
+        return NodePtr(int32_t(uint32_t(ptr))); // keeps NULL_VALUE == -1
+    }
+
+    static uint32_t tagOf(TaggedPtr ptr)
+    {
+        return uint32_t(ptr >> 32);
+    }
+
+    /***** storeElement / loadElement *****/
+    /*------------------------------------------------------------
+        Copy an element into or out of a node, one relaxed atomic word at
+        a time. The links, written with release and read with acquire
+        ordering, make the element of a node visible to the consumers.
+    ---------------------------------------------------------------*/
+    void storeElement(NodePtr index, const ElementType &element)
+    {
+        Word words[WORDS] = {};
+        std::memcpy(words, &element, sizeof(ElementType));
+        for (int w = 0; w < WORDS; w++)
+            arrNode[index].data[w].store(words[w], std::memory_order_relaxed);
+    }
+
+    void loadElement(NodePtr index, ElementType &element) const
+    {
+        Word words[WORDS];
+        for (int w = 0; w < WORDS; w++)
+            words[w] = arrNode[index].data[w].load(std::memory_order_relaxed);
+        std::memcpy(static_cast<void *>(&element), words, sizeof(ElementType));
+    }
+
+    /***** newNode *****/
+    /*------------------------------------------------------------
+        Pops a node from the lock-free free list.
+
+        Precondition: None
+        Post-condition: Returns the index of a node owned by the caller,
+        or NULL_VALUE if every node is in use.
+    ---------------------------------------------------------------*/
+    NodePtr newNode()
+    {
+        TaggedPtr top = free.load(std::memory_order_acquire);
+        while (indexOf(top) != NULL_VALUE)
+        {
+            TaggedPtr next = arrNode[indexOf(top)].next.load(std::memory_order_relaxed);
+            if (free.compare_exchange_weak(top, pack(indexOf(next), tagOf(top) + 1),
+                                           std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return indexOf(top);
+            }
+        }
+        return NULL_VALUE; // the pool is empty
+    }
+
+    /***** returnChain *****/
+    /*------------------------------------------------------------
+        Pushes the chain first..last (already linked from first to last),
+        no longer reachable from the queue, on the free list with one CAS.
+    ---------------------------------------------------------------*/
+    void returnChain(NodePtr firstNode, NodePtr lastNode)
+    {
+        TaggedPtr top = free.load(std::memory_order_relaxed);
+        do
+        {
+            TaggedPtr old = arrNode[lastNode].next.load(std::memory_order_relaxed);
+            arrNode[lastNode].next.store(pack(indexOf(top), tagOf(old) + 1), std::memory_order_relaxed);
+        } while (!free.compare_exchange_weak(top, pack(firstNode, tagOf(top) + 1),
+                                             std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /***** linkChain *****/
+    /*------------------------------------------------------------
+        Appends the chain first..last (already linked, last pointing to
+        NULL_VALUE) at the tail of the queue with one successful CAS.
+    ---------------------------------------------------------------*/
+    void linkChain(NodePtr firstNode, NodePtr lastNode)
+    {
+        while (true)
+        {
+            TaggedPtr last = tail.load(std::memory_order_acquire);
+            TaggedPtr next = arrNode[indexOf(last)].next.load(std::memory_order_acquire);
+            if (last != tail.load(std::memory_order_acquire))
+                continue; // tail moved meanwhile
+            if (indexOf(next) == NULL_VALUE)
+            {
+                // tail is the last node: try to link the chain after it
+                if (arrNode[indexOf(last)].next.compare_exchange_weak(
+                        next, pack(firstNode, tagOf(next) + 1),
+                        std::memory_order_release, std::memory_order_relaxed))
+                {
+                    // try to swing tail to the end of the chain (others may help)
+                    tail.compare_exchange_strong(last, pack(lastNode, tagOf(last) + 1),
+                                                 std::memory_order_release, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            else
+            {
+                // tail is behind: help the other producer by advancing it
+                tail.compare_exchange_weak(last, pack(indexOf(next), tagOf(last) + 1),
+                                           std::memory_order_release, std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    /***** Constructor *****/
+    /*------------------------------------------------------
+        Creates an empty queue: node 0 is the dummy node, and the other
+        nodes are linked together in the free list.
+
+        Precondition: None
+        Post-condition: The queue is empty and can hold Capacity elements
+    -------------------------------------------------------*/
+    ConcurrentQueue()
+    {
+        for (int i = 0; i < POOL_SIZE; i++)
+        {
+            for (int w = 0; w < WORDS; w++)
+                arrNode[i].data[w].store(0, std::memory_order_relaxed);
+            arrNode[i].next.store(pack(i + 1 < POOL_SIZE ? i + 1 : NULL_VALUE, 0), std::memory_order_relaxed);
+        }
+        arrNode[0].next.store(pack(NULL_VALUE, 0), std::memory_order_relaxed); // dummy node
+        head.store(pack(0, 0), std::memory_order_relaxed);
+        tail.store(pack(0, 0), std::memory_order_relaxed);
+        free.store(pack(1, 0), std::memory_order_release);
+    }
+
+    ConcurrentQueue(const ConcurrentQueue &) = delete;            // the nodes are shared
+    ConcurrentQueue &operator=(const ConcurrentQueue &) = delete; // between threads
+
+    /***** tryEnqueue *****/
+    /*------------------------------------------------------------
+        Appends an element at the tail of the queue.
+
+        Precondition: None
+        Post-condition: Returns true if the element was appended, or false
+        (and nothing changes) if the queue is full.
+    ---------------------------------------------------------------*/
+    bool tryEnqueue(const ElementType &element)
+    {
+        NodePtr node = newNode();
+        if (node == NULL_VALUE)
+            return false; // full: the caller decides whether to wait or drop
+        storeElement(node, element);
+        TaggedPtr old = arrNode[node].next.load(std::memory_order_relaxed);
+        arrNode[node].next.store(pack(NULL_VALUE, tagOf(old) + 1), std::memory_order_relaxed);
+        linkChain(node, node);
+        return true;
+    }
+
+    /***** tryDequeue *****/
+    /*------------------------------------------------------------
+        Removes the element at the head of the queue.
+
+        Precondition: None
+        Post-condition: Returns true and stores the element in result, or
+        returns false if the queue is empty.
+    ---------------------------------------------------------------*/
+    bool tryDequeue(ElementType &result)
+    {
+        return dequeueBatch(&result, 1) == 1;
+    }
+
+    /***** enqueueBatch *****/
+    /*------------------------------------------------------------
+        Appends up to count elements. The nodes are taken from the free list
+        and linked together first, then the whole chain is linked to the
+        queue at once, so the elements of a batch stay consecutive.
+
+        Precondition: items holds count elements
+        Post-condition: Returns the number of elements appended (less than
+        count when the queue gets full).
+    ---------------------------------------------------------------*/
+    size_t enqueueBatch(const ElementType *items, size_t count)
+    {
+        NodePtr firstNode = NULL_VALUE;
+        NodePtr lastNode = NULL_VALUE;
+        size_t taken = 0;
+        for (; taken < count; taken++)
+        {
+            NodePtr node = newNode();
+            if (node == NULL_VALUE)
+                break; // full
+            storeElement(node, items[taken]);
+            TaggedPtr old = arrNode[node].next.load(std::memory_order_relaxed);
+            arrNode[node].next.store(pack(NULL_VALUE, tagOf(old) + 1), std::memory_order_relaxed);
+            if (lastNode == NULL_VALUE)
+            {
+                firstNode = node;
+            }
+            else
+            {
+                old = arrNode[lastNode].next.load(std::memory_order_relaxed);
+                arrNode[lastNode].next.store(pack(node, tagOf(old) + 1), std::memory_order_relaxed);
+            }
+            lastNode = node;
+        }
+        if (taken > 0)
+            linkChain(firstNode, lastNode);
+        return taken;
+    }
+
+    /***** dequeueBatch *****/
+    /*------------------------------------------------------------
+        Removes up to count elements with one successful CAS on head: the
+        nodes after the dummy are walked (copying their elements) up to
+        count nodes or the end of the queue, then head jumps to the last
+        node walked, which becomes the new dummy. The old dummy and the
+        nodes before the new one are returned to the free list as one chain.
+
+        Precondition: results has room for count elements
+        Post-condition: Returns the number of elements removed, stored in
+        results in FIFO order (0 when the queue is empty). The entries of
+        results after the ones returned may have been overwritten.
+    ---------------------------------------------------------------*/
+    size_t dequeueBatch(ElementType *results, size_t count)
+    {
+        if (count == 0)
+            return 0;
+        while (true)
+        {
+            TaggedPtr first = head.load(std::memory_order_acquire);
+            TaggedPtr last = tail.load(std::memory_order_acquire);
+            NodePtr previous = NULL_VALUE; // the node before the new dummy
+            NodePtr current = indexOf(first);
+            bool tailBehind = false;       // tail is on a node that would be freed
+            size_t taken = 0;
+            while (taken < count)
+            {
+                NodePtr next = indexOf(arrNode[current].next.load(std::memory_order_acquire));
+                if (next == NULL_VALUE)
+                    break; // end of the queue
+                if (current == indexOf(last))
+                    tailBehind = true;
+                loadElement(next, results[taken]); // kept only if head is claimed below
+                previous = current;
+                current = next;
+                taken++;
+            }
+            if (first != head.load(std::memory_order_acquire))
+                continue; // head moved meanwhile: the walk may be stale
+            if (taken == 0)
+                return 0; // only the dummy node: empty
+            if (tailBehind)
+            {
+                // help the producer by advancing tail before freeing its node
+                TaggedPtr next = arrNode[indexOf(last)].next.load(std::memory_order_acquire);
+                if (indexOf(next) != NULL_VALUE)
+                    tail.compare_exchange_weak(last, pack(indexOf(next), tagOf(last) + 1),
+                                               std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+            if (head.compare_exchange_weak(first, pack(current, tagOf(first) + 1),
+                                           std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                returnChain(indexOf(first), previous); // old dummy .. node before the new dummy
+                return taken;
+            }
+        }
+    }
+
+    /***** capacity / isEmpty *****/
+    int capacity() const
+    {
+        return Capacity;
+    }
+
+    bool isEmpty() const
+    {
+        TaggedPtr first = head.load(std::memory_order_acquire);
+        return indexOf(arrNode[indexOf(first)].next.load(std::memory_order_acquire)) == NULL_VALUE;
+    }
+};
+
+#endif
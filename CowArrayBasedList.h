@@ -0,0 +1,194 @@
+#ifndef COWARRAYBASEDLIST_H
+#define COWARRAYBASEDLIST_H
+
+/**--CowArrayBasedList.h---------------------------------------------------------------------
+    This template class wraps an ArrayBasedList in a copy-on-write handle. Copying a
+    CowArrayBasedList does not copy any node: the copies share the same list (and so
+    the same storage pool) until one of them is modified. Only then does the modified
+    copy take its own deep copy of the list. This makes snapshots of a list almost free
+    when they are rarely modified.
+
+    Basic Operations:
+    Constructor: Creates an empty list, or a list holding a copy of an ArrayBasedList
+    Copy Constructor / Assignment Operator: Share the list of the other object (no copy)
+    view: Gives read-only access to the underlying list
+    isShared: Tells whether another copy is currently sharing the list
+
+    The reading operations (getsize, search, display...) are forwarded to the shared
+    list, and the modifying operations (insertFirst, deleteLast, removeIf...) detach
+    first. There is no public write access to the underlying list: a reference kept
+    after a later copy would modify a list shared with that copy.
+
+    The template parameters are those of ArrayBasedList (capacity, node alignment, key
+    policies, access counters), and are forwarded to the wrapped list.
+
+    Copies sharing a list may be used by different threads, for example snapshots read
+    by request handlers while the original is modified. The copies of a list are counted
+    with an atomic counter: a copy that goes away decrements it with release ordering,
+    and a write reads it with acquire ordering, so when a write finds the list unshared
+    and modifies it in place, everything the other copies did with the list happened
+    before.
+
+    Class Invariants:
+    1. shared is never null, and shared->owners is the number of objects pointing to it
+    2. A list reachable from more than one CowArrayBasedList is never modified
+
+    Note: Like ArrayBasedList, a CowArrayBasedList object must not be modified by one
+    thread while another thread uses or copies the same object.
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <atomic>
+
+template <typename ElementType,           // These parameters are forwarded
+          int Capacity = NUM_NODES,       // to ArrayBasedList (see ArrayBasedList.h)
+          size_t NodeAlignment = 0,
+          typename KeyEqual = equal_to<ElementType>,
+          typename Hash = conditional_t<is_same_v<KeyEqual, equal_to<ElementType>> || is_same_v<KeyEqual, equal_to<>>,
+                                        hash<ElementType>, void>,
+          bool CountAccesses = false>
+class CowArrayBasedList
+{
+public:
+    typedef ArrayBasedList<ElementType, Capacity, NodeAlignment, KeyEqual, Hash, CountAccesses> ListType; // the wrapped list
+
+private:
+    /**--SharedList--------------------------------------------------
+     The list and the number of CowArrayBasedList objects sharing it.
+     ---------------------------------------------------------------**/
+    struct SharedList
+    {
+        ListType list;
+        atomic<long> owners;
+
+        SharedList() : list(), owners(1) {}
+        explicit SharedList(const ListType &origList) : list(origList), owners(1) {}
+    };
+
+    SharedList *shared; // the list shared between copies
+
+    /***** release *****/
+    /*-----------------------------------------------------------------------
+     Stops sharing the list, and deletes it if this object was the last owner.
+     The release ordering publishes the reads of this object to the thread
+     that next writes the list in place (see detach).
+     -----------------------------------------------------------------------*/
+    void release()
+    {
+        if (shared->owners.fetch_sub(1, memory_order_acq_rel) == 1)
+            delete shared;
+    }
+
+    /***** edit *****/
+    /*-----------------------------------------------------------------------
+     Returns the list for modification, after copying it if it was shared. Only
+     used by the modifying operations, which drop the reference right away.
+
+     Precondition: None
+     Post-condition: The list is only reachable from this object
+     -----------------------------------------------------------------------*/
+    ListType &edit()
+    {
+        detach();
+        return shared->list;
+    }
+
+    /***** detach *****/
+    /*-----------------------------------------------------------------------
+     Gives this object its own copy of the list if the list is shared.
+
+     Precondition: None
+     Post-condition: list is only reachable from this object
+     -----------------------------------------------------------------------*/
+    void detach()
+    {
+        if (shared->owners.load(memory_order_acquire) > 1)
+        {
+            SharedList *copy = new SharedList(shared->list); // deep copy
+            release();
+            shared = copy;
+        }
+    }
+
+public:
+    /***** Constructors *****/
+    /*------------------------------------------------------
+        Creates an empty list, or a list holding a copy of origList.
+
+        Precondition: None
+        Post-condition: The list is not shared with any other object
+    -------------------------------------------------------*/
+    CowArrayBasedList() : shared(new SharedList()) {}
+
+    explicit CowArrayBasedList(const ListType &origList)
+        : shared(new SharedList(origList)) {}
+
+    /***** Copy Constructor / Assignment Operator *****/
+    /*------------------------------------------------------
+        Share the list of the other object; the nodes are copied on the
+        first write (see detach).
+    -------------------------------------------------------*/
+    CowArrayBasedList(const CowArrayBasedList &other) : shared(other.shared)
+    {
+        shared->owners.fetch_add(1, memory_order_relaxed);
+    }
+
+    CowArrayBasedList &operator=(const CowArrayBasedList &other)
+    {
+        other.shared->owners.fetch_add(1, memory_order_relaxed); // first: other may be *this
+        release();
+        shared = other.shared;
+        return *this;
+    }
+
+    /***** Destructor *****/
+    ~CowArrayBasedList()
+    {
+        release();
+    }
+
+    /***** view *****/
+    /*------------------------------------------------------------------------
+    Returns the list for reading. The reference must not be kept past the next
+    modification of this object, which may replace the list.
+    -----------------------------------------------------------------------*/
+    const ListType &view() const
+    {
+        return shared->list;
+    }
+
+    bool isShared() const
+    {
+        return shared->owners.load(memory_order_acquire) > 1;
+    }
+
+    /***** Reading Operations *****/
+    int getsize() const { return shared->list.getsize(); }
+    bool isEmpty() const { return shared->list.isEmpty(); }
+    int search(const ElementType &element) const { return shared->list.searchNoReorder(element); } // a shared list is never reordered
+    void display(ostream &out) const { shared->list.display(out); }
+    void rdisplay(ostream &out) const { shared->list.rdisplay(out); }
+
+    /***** Modifying Operations *****/
+    void insertFirst(const ElementType &element) { edit().insertFirst(element); }
+    void insertLast(const ElementType &element) { edit().insertLast(element); }
+    void insertAtPos(const ElementType &element, unsigned pos) { edit().insertAtPos(element, pos); }
+    void insertAfter(const ElementType &element, const ElementType &after) { edit().insertAfter(element, after); }
+    void deleteFirst() { edit().deleteFirst(); }
+    void deleteLast() { edit().deleteLast(); }
+    void deleteAtPos(unsigned int pos) { edit().deleteAtPos(pos); }
+    void deleteElement(const ElementType &element) { edit().deleteElement(element); }
+    void reverse() { edit().reverse(); }
+    int appendAll(const vector<ElementType> &items) { return edit().appendAll(items); }
+    int removeAll(const ElementType &element) { return edit().removeAll(element); }
+    template <typename Predicate>
+    int removeIf(Predicate condition) { return edit().removeIf(condition); }
+
+    /***** Overloaded Output Operator *****/
+    friend ostream &operator<<(ostream &out, const CowArrayBasedList &cowList)
+    {
+        cowList.display(out);
+        return out;
+    }
+};
+
+#endif
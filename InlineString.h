@@ -0,0 +1,217 @@
+#ifndef INLINESTRING_H
+#define INLINESTRING_H
+
+/**--InlineString.h---------------------------------------------------------------------------
+    This template class is a fixed-capacity string meant to be used as the ElementType of
+    an ArrayBasedList of short strings (ArrayBasedList<ShortString> instead of
+    ArrayBasedList<string>). The characters are stored inside the node itself, so
+    inserting, copying or deleting an element never allocates on the heap, and a list of
+    InlineString is trivially copyable (its storage pool is cloned in one block copy).
+
+    A 32-bit hash of the characters is computed once, when the string is assigned.
+    Comparing two strings first compares their hashes and lengths, so search and
+    deleteElement only compare characters when the hashes match, which is rare for
+    strings that are different.
+
+    Basic Operations:
+    Constructors: Build an empty string, or (explicitly) a string from a C string, string
+    or string_view that fits
+    tryCreate: Builds a string from any text, or fails if the text is too long
+    fits: Tells whether a text is short enough to be stored
+    length, c_str, str, getHash: Give access to the stored string
+    Operators: ==, != (hash first, then characters; or against any string key), <<, >>
+
+    Everything but the stream operators is constexpr (C++20), so lists of short strings
+    can be built at compile time.
+
+    Class Invariants:
+    1. length <= Capacity and chars[length] == '\0'
+    2. hash is always the hash of the first length characters
+
+    NOTE: A text longer than Capacity is never stored, not even in part: two long texts
+    with the same first characters would otherwise become equal strings. The converting
+    constructors are explicit, so a text is never converted by accident (for example by
+    ArrayBasedList<ShortString>::insertLast(text)). Use tryCreate, which fails on a text
+    that does not fit, when the text comes from the user; the constructors require a text
+    that fits (otherwise the string is left empty and a message reports it, and during
+    constant evaluation it does not compile), and >> sets failbit on a word that does not
+    fit. A key compared with an InlineString is never converted either: a key longer than
+    Capacity matches no InlineString.
+-------------------------------------------------------------------------------------------*/
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+template <unsigned Capacity> // maximum number of characters stored inline
+class InlineString
+{
+    static_assert(Capacity > 0 && Capacity < 256, "InlineString capacity must be in [1, 255]");
+
+private:
+    uint32_t hash;             // hash of the stored characters
+    unsigned char len;         // number of stored characters
+    char chars[Capacity + 1];  // the characters, followed by '\0'
+
+    /***** computeHash *****/
+    /*-----------------------------------------------------------------
+     32-bit FNV-1a hash of the stored characters.
+     ------------------------------------------------------------------*/
+    constexpr static uint32_t computeHash(const char *text, unsigned count)
+    {
+        uint32_t h = 2166136261u; // FNV offset basis
+        for (unsigned i = 0; i < count; i++)
+        {
+            h ^= static_cast<unsigned char>(text[i]);
+            h *= 16777619u; // FNV prime
+        }
+        return h;
+    }
+
+    /***** reportTooLong *****/
+    /*-----------------------------------------------------------------
+     Tells the user that text did not fit. Not constexpr on purpose: a
+     text too long during constant evaluation is a compile error.
+     ------------------------------------------------------------------*/
+    static void reportTooLong(std::string_view text)
+    {
+        std::cout << text << " is longer than " << Capacity
+                  << " characters and was not stored" << std::endl;
+    }
+
+    /***** assign *****/
+    /*-----------------------------------------------------------------
+     Copies the characters of text, which must fit, and updates the hash.
+     ------------------------------------------------------------------*/
+    constexpr void assign(std::string_view text)
+    {
+        len = static_cast<unsigned char>(text.size());
+        std::char_traits<char>::copy(chars, text.data(), len);
+        std::char_traits<char>::assign(chars + len, Capacity + 1 - len, '\0'); // also clears the unused bytes
+        hash = computeHash(chars, len);
+    }
+
+public:
+    /***** Constructors *****/
+    /*------------------------------------------------------
+        Creates an empty string, or a copy of the given text.
+
+        Precondition: fits(text) (use tryCreate otherwise)
+        Post-condition: The string holds text, or is empty (and a message
+        reports it) if text is too long
+    -------------------------------------------------------*/
+    constexpr InlineString() { assign(std::string_view()); }
+    explicit constexpr InlineString(const char *text) : InlineString(std::string_view(text)) {}
+    explicit constexpr InlineString(const std::string &text) : InlineString(std::string_view(text)) {}
+    explicit constexpr InlineString(std::string_view text)
+    {
+        if (fits(text))
+        {
+            assign(text);
+            return;
+        }
+        reportTooLong(text);
+        assign(std::string_view());
+    }
+
+    /***** tryCreate *****/
+    /*------------------------------------------------------
+        Stores text in result if it fits.
+
+        Precondition: None
+        Post-condition: Returns true and result holds text, or returns false
+        (and result is unchanged) if text is longer than Capacity
+    -------------------------------------------------------*/
+    constexpr static bool tryCreate(std::string_view text, InlineString &result)
+    {
+        if (!fits(text))
+            return false;
+        result.assign(text);
+        return true;
+    }
+
+    /***** fits *****/
+    /*------------------------------------------------------
+        Checks whether text is short enough to be stored.
+    -------------------------------------------------------*/
+    constexpr static bool fits(std::string_view text)
+    {
+        return text.size() <= Capacity;
+    }
+
+    /***** Getters *****/
+    constexpr unsigned length() const { return len; }
+    constexpr const char *c_str() const { return chars; }
+    constexpr std::string str() const { return std::string(chars, len); }
+    constexpr std::string_view view() const { return std::string_view(chars, len); }
+    constexpr uint32_t getHash() const { return hash; }
+
+    /***** Equality Operators *****/
+    /*------------------------------------------------------
+        Two strings are equal if they hold the same characters. The hashes and
+        lengths are compared first, so different strings are almost always told
+        apart with an integer comparison.
+    -------------------------------------------------------*/
+    friend constexpr bool operator==(const InlineString &left, const InlineString &right)
+    {
+        return left.hash == right.hash && left.len == right.len &&
+               std::char_traits<char>::compare(left.chars, right.chars, left.len) == 0;
+    }
+
+    friend constexpr bool operator!=(const InlineString &left, const InlineString &right)
+    {
+        return !(left == right);
+    }
+
+    /***** Equality Operators (string keys) *****/
+    /*------------------------------------------------------
+        Compare with any text convertible to string_view (C string, string,
+        string_view) without building an InlineString: a key longer than
+        Capacity is never equal. The reversed and != forms are derived from it.
+    -------------------------------------------------------*/
+    template <typename Text>
+        requires std::is_convertible_v<const Text &, std::string_view>
+    friend constexpr bool operator==(const InlineString &left, const Text &right)
+    {
+        return left.view() == std::string_view(right);
+    }
+
+    /***** Stream Operators *****/
+    friend std::ostream &operator<<(std::ostream &out, const InlineString &text)
+    {
+        return out.write(text.chars, text.len); // the length is known: no strlen
+    }
+
+    friend std::istream &operator>>(std::istream &in, InlineString &text)
+    {
+        std::string word; // read a whole word, then check that it fits
+        if (in >> word && !tryCreate(word, text))
+        {
+            in.setstate(std::ios::failbit); // text is unchanged
+        }
+        return in;
+    }
+};
+
+// A short string that takes exactly 32 bytes in a node
+typedef InlineString<26> ShortString;
+
+/***** std::hash specialization *****/
+/*------------------------------------------------------
+    Reuses the hash stored in the string, so hashing is free.
+-------------------------------------------------------*/
+namespace std
+{
+    template <unsigned Capacity>
+    struct hash<InlineString<Capacity>>
+    {
+        size_t operator()(const InlineString<Capacity> &text) const
+        {
+            return text.getHash();
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,296 @@
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+/**--LruCache.h---------------------------------------------------------------------------------
+    This template class is a fixed-capacity cache that evicts the Least Recently Used entry
+    when it is full. It is built like ArrayBasedList: the entries are the nodes of a NodePool,
+    linked by indices in order of recency (most recent first), and a hash table maps every
+    key to the index of its node. No memory is allocated after construction.
+
+    Basic Operations:
+    Constructor: Creates an empty cache
+    get: Looks a key up; on a hit, the entry becomes the most recently used
+    put: Inserts or updates an entry; when the cache is full, the least recently used
+         node is reused in place for the new entry
+    contains: Checks whether a key is cached, without changing the recency order
+    erase: Removes an entry
+    Statistics: getHits, getMisses, getEvictions, hitRate, resetStats
+
+    The hash table uses open addressing with linear probing. It has a power-of-two number
+    of slots, at least twice the capacity, so it is never more than half full and probes
+    stay short. Deleted keys are removed by shifting the following keys back (no tombstones).
+
+    Class Invariants:
+    1. mostRecent == NULL_VALUE if and only if the cache is empty
+    2. Every key in the cache has exactly one node and one slot in the table
+    3. count <= Capacity
+-------------------------------------------------------------------------------------------*/
+#include "NodePool.h"
+#include <cstddef>
+#include <functional>
+
+template <typename KeyType, typename ValueType, int Capacity = NUM_NODES, typename Hash = std::hash<KeyType>>
+class LruCache
+{
+    static_assert(Capacity > 0, "LruCache capacity must be positive");
+
+private:
+    /**--Entry--------------------------------------------------
+     The element stored in each node of the storage pool.
+     ---------------------------------------------------------------**/
+    struct Entry
+    {
+        KeyType key;
+        ValueType value;
+    };
+
+    // Smallest power of two that is at least 2 * Capacity
+    static constexpr int tableSize()
+    {
+        int n = 1;
+        while (n < 2 * Capacity)
+            n *= 2;
+        return n;
+    }
+    static const int TABLE_SIZE = tableSize();
+
+    NodePool<Entry, Capacity> storagePool; // the entries, linked in order of recency
+    NodePtr table[TABLE_SIZE];             // key -> node index (NULL_VALUE: empty slot)
+    NodePtr mostRecent;                    // head of the recency list
+    NodePtr leastRecent;                   // tail of the recency list (next to be evicted)
+    int count;                             // number of entries
+    Hash hasher;                           // hash function of the keys
+    unsigned long hits, misses, evictions; // statistics
+
+    /***** homeSlot *****/
+    int homeSlot(const KeyType &key) const
+    {
+        return int(hasher(key) & (TABLE_SIZE - 1));
+    }
+
+    /***** findSlot *****/
+    /*-----------------------------------------------------------------------
+     Returns the table slot holding key, or -1 if key is not cached.
+     -----------------------------------------------------------------------*/
+    int findSlot(const KeyType &key) const
+    {
+        for (int slot = homeSlot(key); table[slot] != NULL_VALUE; slot = (slot + 1) & (TABLE_SIZE - 1))
+        {
+            if (storagePool.getNode(table[slot]).data.key == key)
+                return slot;
+        }
+        return -1;
+    }
+
+    /***** insertSlot *****/
+    /*-----------------------------------------------------------------------
+     Stores the node of a key that is not in the table yet.
+     -----------------------------------------------------------------------*/
+    void insertSlot(const KeyType &key, NodePtr node)
+    {
+        int slot = homeSlot(key);
+        while (table[slot] != NULL_VALUE)
+            slot = (slot + 1) & (TABLE_SIZE - 1); // linear probing
+        table[slot] = node;
+    }
+
+    /***** removeSlot *****/
+    /*-----------------------------------------------------------------------
+     Empties a slot, then moves back the following keys of the probe sequence
+     that would not be found anymore (backward shift deletion).
+     -----------------------------------------------------------------------*/
+    void removeSlot(int slot)
+    {
+        int hole = slot;
+        for (int next = (hole + 1) & (TABLE_SIZE - 1); table[next] != NULL_VALUE;
+             next = (next + 1) & (TABLE_SIZE - 1))
+        {
+            int home = homeSlot(storagePool.getNode(table[next]).data.key);
+            // the key at next can fill the hole if its home is not in (hole, next]
+            if (((next - home) & (TABLE_SIZE - 1)) >= ((next - hole) & (TABLE_SIZE - 1)))
+            {
+                table[hole] = table[next];
+                hole = next;
+            }
+        }
+        table[hole] = NULL_VALUE;
+    }
+
+    /***** unlink / linkFront *****/
+    /*-----------------------------------------------------------------------
+     Remove a node from the recency list, and insert a node at its front.
+     -----------------------------------------------------------------------*/
+    void unlink(NodePtr node)
+    {
+        NodePtr pred = storagePool.getNode(node).prev;
+        NodePtr succ = storagePool.getNode(node).next;
+        if (pred == NULL_VALUE)
+            mostRecent = succ;
+        else
+            storagePool.getNode(pred).next = succ;
+        if (succ == NULL_VALUE)
+            leastRecent = pred;
+        else
+            storagePool.getNode(succ).prev = pred;
+    }
+
+    void linkFront(NodePtr node)
+    {
+        storagePool.getNode(node).prev = NULL_VALUE;
+        storagePool.getNode(node).next = mostRecent;
+        if (mostRecent == NULL_VALUE)
+            leastRecent = node; // the only node
+        else
+            storagePool.getNode(mostRecent).prev = node;
+        mostRecent = node;
+    }
+
+    /***** moveToFront *****/
+    void moveToFront(NodePtr node)
+    {
+        if (node != mostRecent)
+        {
+            unlink(node);
+            linkFront(node);
+        }
+    }
+
+public:
+    /***** Constructor *****/
+    /*------------------------------------------------------
+        Creates an empty cache with empty statistics.
+
+        Precondition: None
+        Post-condition: Every table slot is empty and the recency list is empty
+    -------------------------------------------------------*/
+    LruCache() : mostRecent(NULL_VALUE), leastRecent(NULL_VALUE), count(0),
+                 hits(0), misses(0), evictions(0)
+    {
+        for (int i = 0; i < TABLE_SIZE; i++)
+            table[i] = NULL_VALUE;
+    }
+
+    /***** get *****/
+    /*------------------------------------------------------
+        Looks key up in O(1). On a hit, the entry becomes the most recently used.
+
+        Precondition: None
+        Post-condition: Returns a pointer to the cached value (valid until the next
+        put or erase), or nullptr on a miss. The hit or miss is counted.
+    -------------------------------------------------------*/
+    ValueType *get(const KeyType &key)
+    {
+        int slot = findSlot(key);
+        if (slot < 0)
+        {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        moveToFront(table[slot]);
+        return &storagePool.getNode(table[slot]).data.value;
+    }
+
+    /***** get (copy) *****/
+    /*------------------------------------------------------
+        Same as get, but copies the value into result.
+        Returns true on a hit and false on a miss.
+    -------------------------------------------------------*/
+    bool get(const KeyType &key, ValueType &result)
+    {
+        ValueType *value = get(key);
+        if (value == nullptr)
+            return false;
+        result = *value;
+        return true;
+    }
+
+    /***** put *****/
+    /*------------------------------------------------------
+        Caches value for key in O(1), as the most recently used entry. If key is
+        already cached, its value is replaced. Otherwise, if the cache is full, the
+        least recently used entry is evicted and its node is reused in place.
+
+        Precondition: None
+        Post-condition: key is cached with value and is the most recently used entry
+    -------------------------------------------------------*/
+    void put(const KeyType &key, const ValueType &value)
+    {
+        int slot = findSlot(key);
+        if (slot >= 0)
+        {
+            storagePool.getNode(table[slot]).data.value = value; // update
+            moveToFront(table[slot]);
+            return;
+        }
+
+        NodePtr node;
+        if (count == Capacity)
+        {
+            // Evict: the least recently used node is recycled for the new entry
+            node = leastRecent;
+            removeSlot(findSlot(storagePool.getNode(node).data.key));
+            unlink(node);
+            evictions++;
+        }
+        else
+        {
+            node = storagePool.newNode();
+            count++;
+        }
+        storagePool.getNode(node).data.key = key;
+        storagePool.getNode(node).data.value = value;
+        linkFront(node);
+        insertSlot(key, node);
+    }
+
+    /***** contains *****/
+    /*------------------------------------------------------
+        Checks whether key is cached, without changing the recency order
+        or the statistics.
+    -------------------------------------------------------*/
+    bool contains(const KeyType &key) const
+    {
+        return findSlot(key) >= 0;
+    }
+
+    /***** erase *****/
+    /*------------------------------------------------------
+        Removes the entry of key, if any, and frees its node.
+        Returns true if an entry was removed.
+    -------------------------------------------------------*/
+    bool erase(const KeyType &key)
+    {
+        int slot = findSlot(key);
+        if (slot < 0)
+            return false;
+        NodePtr node = table[slot];
+        removeSlot(slot);
+        unlink(node);
+        storagePool.returnNode(node);
+        count--;
+        return true;
+    }
+
+    /***** Getters and Statistics *****/
+    int getsize() const { return count; }
+    int capacity() const { return Capacity; }
+    bool isEmpty() const { return count == 0; }
+    unsigned long getHits() const { return hits; }
+    unsigned long getMisses() const { return misses; }
+    unsigned long getEvictions() const { return evictions; }
+
+    // Fraction of the get calls that were hits (0 if get was never called)
+    double hitRate() const
+    {
+        unsigned long lookups = hits + misses;
+        return lookups == 0 ? 0.0 : double(hits) / double(lookups);
+    }
+
+    void resetStats()
+    {
+        hits = misses = evictions = 0;
+    }
+};
+
+#endif
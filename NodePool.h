@@ -3,38 +3,179 @@
 
 /**-- NodePool.h------------------------------------------------------------------
     This header file manages a fixed-size storage pool of nodes used in a linked list.
+    The number of nodes is a template parameter (NUM_NODES by default), and so is the
+    alignment of the nodes: with NodeAlignment = CACHE_LINE_SIZE (or nodeStride<E>() for
+    the next power of two), every node starts on its own boundary and is padded up to it,
+    so no node straddles two cache lines. 0 (the default) keeps the natural layout.
+    See PoolStorage.h to place large pools on huge pages or on a given NUMA node.
     Using an array of nodes, this template class manages the nodes , setting the linked
     list up for multiple operations.
 
     Basic Operations:
-        Constructor: Initializes the storage pool and links every node to the next one,
-        but the last one. This gives us a free list, a list where all nodes are free.
+        Constructor: Initializes an empty storage pool in O(1). Nothing is built or
+        linked: the nodes are handed out in order from a bump index (highWater) the
+        first time, and the freed nodes are recycled through the free list.
+        An optional memory resource can be given: allocator-aware elements (such as
+        std::pmr::string) are then built with it, so their own allocations come from
+        that resource instead of the global heap.
         newNode: Allocates and returns the index of the first free node in the pool
         while assigning a new node to the free index/list
         returnNode: Frees a node by assigning
+        returnChain: Frees a whole chain of linked nodes at once
         getNode: Provides access to the node by reference
+        prefetchNode: Starts loading a node into the cache ahead of its use
         getFree: (this was used only for debugging): it returns the index of the free node
         isFull: Checks if the storage pool is full
+        getResource: Returns the memory resource of the elements (nullptr: global heap)
+        makeHandle / isCurrent: Build and check generation-tagged handles to nodes
+        cloneFrom: Copies another storage pool, in a single block copy when the
+        nodes are trivially copyable
+        setPolicy / getPolicy: Select how newNode chooses the free node to allocate
+        allocateRun: Allocates several physically contiguous nodes at once
+        countFree: Returns the number of free nodes
+        reset: Frees every node at once, in O(1)
+        getHighWater: Returns the number of nodes handed out since construction or reset
+
+    Every node has a generation counter that is incremented when the node is allocated
+    and again when it is freed, so it is odd exactly while the node is in use. A
+    NodeHandle remembers the index AND the generation of a node: once the node is freed
+    (and maybe reused), the generations differ and the handle is detected as stale.
+
+    Allocation policies: with LIFO_POLICY (the default), the last freed node is the next
+    one allocated, which is the cheapest but scatters the nodes of a list across the
+    array after many insertions and deletions. With LOWEST_INDEX_POLICY, newNode always
+    allocates the free node with the lowest index, so the nodes in use stay packed at
+    the beginning of the array. The free nodes are tracked in a hierarchical bitmap, in
+    both policies: one bit per node, then one bit per 64-bit word of the level below, up
+    to a single top word (2 levels up to 4096 nodes, 3 up to 262144, 4 up to 16M). The
+    lowest free node is found with one count-trailing-zeros instruction per level, from
+    the top word down, so its cost does not grow with the capacity of the pool.
+
+    Every operation but the memory resource constructor is constexpr (C++20), so a
+    storage pool can be filled during constant evaluation.
 
 ----------------------------------------------------------------------------------**/
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
 
 const int NULL_VALUE = -1; // Expresses that a node is last in the list or there's no free node
-const int NUM_NODES = 10;   // The number of nodes available in the storage pool
+const int NUM_NODES = 10;   // The default number of nodes available in a storage pool
 typedef int NodePtr;       // an alias for the index pointers
 
-template <typename ElementType> // A type of class where the type of data is user-defined
+// How NodePool::newNode chooses the free node it allocates
+enum AllocationPolicy
+{
+    LIFO_POLICY,        // the most recently freed node (free list)
+    LOWEST_INDEX_POLICY // the free node with the lowest index (bitmap)
+};
+
+/**--NodeHandle----------------------------------------------------------
+ A stable reference to a node: its index and the generation of the node
+ when the handle was made. Handles can be kept by the user (for example in
+ a map) and are checked before being used.
+ ----------------------------------------------------------------------**/
+struct NodeHandle
+{
+    NodePtr index;         // index of the node in the storage pool
+    unsigned generation;   // generation of the node when the handle was made
+
+    constexpr bool operator==(const NodeHandle &other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    constexpr bool operator!=(const NodeHandle &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+constexpr NodeHandle NULL_HANDLE = {NULL_VALUE, 0}; // A handle to no node
+
+const std::size_t CACHE_LINE_SIZE = 64; // Size in bytes of a cache line
+
+const int MAX_BITMAP_LEVELS = 6; // 64^6 bits are more than any int capacity
+
+/**--BitmapLayout--------------------------------------------------------
+ Where the levels of the free bitmap of a pool are, in one array of 64-bit
+ words: level 0 has one bit per node, and every other level one bit per
+ word of the level below, up to a level of a single word.
+ ----------------------------------------------------------------------**/
+struct BitmapLayout
+{
+    int levels;                        // number of levels (the last one is a single word)
+    int offset[MAX_BITMAP_LEVELS + 1]; // first word of each level; offset[levels]: all the words
+};
+
+/***** bitmapLayout *****/
+constexpr BitmapLayout bitmapLayout(int capacity)
+{
+    BitmapLayout layout = {0, {}};
+    int words = (capacity + 63) / 64; // words of the current level
+    int offset = 0;
+    while (true)
+    {
+        layout.offset[layout.levels++] = offset;
+        offset += words;
+        if (words == 1)
+            break;
+        words = (words + 63) / 64;
+    }
+    layout.offset[layout.levels] = offset;
+    return layout;
+}
+
+/**--nodeStride----------------------------------------------------------
+ Returns the smallest power of two that can hold a node of ElementType,
+ to be used as NodeAlignment so that nodes never straddle a cache line
+ (when the node is smaller than a cache line) and are found by shifting.
+ ----------------------------------------------------------------------**/
+template <typename ElementType>
+constexpr std::size_t nodeStride()
+{
+    struct NaturalNode // same members as NodePool::NodeType
+    {
+        ElementType data;
+        NodePtr next;
+        NodePtr prev;
+    };
+    std::size_t stride = 1;
+    while (stride < sizeof(NaturalNode))
+        stride *= 2;
+    return stride;
+}
+
+template <typename ElementType,            // A type of class where the type of data is user-defined
+          int Capacity = NUM_NODES,        // The number of nodes of this storage pool
+          std::size_t NodeAlignment = 0>   // Alignment (and stride) of the nodes; 0: natural
 class NodePool
 { // Forward Declaration
 private:
+    static constexpr BitmapLayout BITMAP = bitmapLayout(Capacity); // levels of freeBits
+
+    static_assert(NodeAlignment == 0 || (NodeAlignment & (NodeAlignment - 1)) == 0,
+                  "NodeAlignment must be 0 or a power of two");
+    static constexpr std::size_t NATURAL_ALIGNMENT =
+        alignof(ElementType) > alignof(NodePtr) ? alignof(ElementType) : alignof(NodePtr);
+    static constexpr std::size_t NODE_ALIGNMENT = // never less than the natural alignment
+        NodeAlignment > NATURAL_ALIGNMENT ? NodeAlignment : NATURAL_ALIGNMENT;
+
     /**--NodeType--------------------------------------------------
-     A node struct that holds an element of user-defined data type (in our case string)
-     and an index "next" that points to the next node of the list.
+     A node struct that holds an element of user-defined data type (in our case string),
+     an index "next" that points to the next node of the list and an index "prev" that
+     points to the previous one (so a node can be unlinked without searching for it).
      It is considered private to assure encapsulation and avoid leaks, or breach by the user.
      ---------------------------------------------------------------**/
-    struct NodeType
+    struct alignas(NODE_ALIGNMENT) NodeType
     {                     // Struct Declaration
         ElementType data; // data stored in the node
         NodePtr next;     // index of the next node
+        NodePtr prev;     // index of the previous node
 
         /***** NodeType (no-argument constructor) *****/
         /*-----------------------------------------------------------
@@ -42,7 +183,7 @@ private:
         value and setting the next index to NULL_VALUE, indicating
         that the node has no successor.
         ------------------------------------------------------------*/
-        NodeType() : data(), next(NULL_VALUE) {} 
+        constexpr NodeType() : data(), next(NULL_VALUE), prev(NULL_VALUE) {}
 
         /***** NodeType (parameterized constructor) *****/
         /*-----------------------------------------------------------
@@ -50,38 +191,312 @@ private:
         the next index to the specified value. If no next value is
         provided, it defaults to NULL_VALUE, indicating no successor.
         ------------------------------------------------------------*/
-        NodeType(const ElementType& item, NodePtr n = NULL_VALUE)
+        constexpr NodeType(const ElementType& item, NodePtr n = NULL_VALUE)
         {
             data = item;
             next = n;
+            prev = NULL_VALUE;
         }
 
     };
 
-    NodeType arrNode[NUM_NODES]; // Array of nodes
-    NodePtr free;                // Index of the first free node
+    /**--Slot--------------------------------------------------
+     Storage of one node. The node is only built the first time the slot is
+     handed out (or, during constant evaluation, by the constructor), so
+     building a pool does not build Capacity elements.
+     ---------------------------------------------------------------**/
+    union Slot
+    {
+        NodeType node; // the node, once the slot is built
+
+        constexpr Slot() {} // the node is not built yet
+        constexpr ~Slot()
+            requires std::is_trivially_destructible_v<NodeType>
+        = default;
+        constexpr ~Slot() {} // the pool destroys the nodes it built
+    };
+
+    Slot arrNode[Capacity];              // Array of nodes
+    NodePtr free;                        // Index of the first recycled free node
+    int highWater;                       // Nodes [highWater, Capacity) were never handed out
+    int constructed;                     // Nodes [0, constructed) are built (and have a generation)
+    unsigned generation[Capacity];       // Generation of each node (odd: in use)
+    std::pmr::memory_resource *resource; // Resource used by the elements (nullptr: global heap)
+    AllocationPolicy policy;             // How newNode chooses the node to allocate
+    uint64_t freeBits[BITMAP.offset[BITMAP.levels]]; // Level 0: bit i is set when node i < highWater
+                                                     // is free; above: bit w is set when word w of
+                                                     // the level below has a free node
+
+    /***** lowestBit / countBits *****/
+    /*------------------------------------------------------
+        Index of the lowest set bit of a non-zero word, and number of set bits
+        of a word (count-trailing-zeros and popcount instructions when available).
+    -------------------------------------------------------*/
+    constexpr static int lowestBit(uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(word);
+#else
+        int bit = 0;
+        while ((word & 1) == 0)
+        {
+            word >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    constexpr static int countBits(uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        int count = 0;
+        for (; word != 0; word &= word - 1)
+            count++;
+        return count;
+#endif
+    }
+
+    /***** markFree / markUsed *****/
+    /*------------------------------------------------------
+        Keep every level of the bitmap up to date when a node is freed or
+        allocated. They go up only while a word changes between empty and
+        not empty, so they usually stop at level 0.
+    -------------------------------------------------------*/
+    constexpr void markFree(NodePtr index)
+    {
+        int bit = index; // bit of the node, then of its word in the level above
+        for (int level = 0; level < BITMAP.levels; level++)
+        {
+            uint64_t &word = freeBits[BITMAP.offset[level] + bit / 64];
+            bool hadFree = word != 0;
+            word |= uint64_t(1) << (bit % 64);
+            if (hadFree)
+                return; // the levels above already know the word has a free node
+            bit /= 64;
+        }
+    }
+
+    constexpr void markUsed(NodePtr index)
+    {
+        int bit = index;
+        for (int level = 0; level < BITMAP.levels; level++)
+        {
+            uint64_t &word = freeBits[BITMAP.offset[level] + bit / 64];
+            word &= ~(uint64_t(1) << (bit % 64));
+            if (word != 0)
+                return; // the word still has a free node
+            bit /= 64;
+        }
+    }
+
+    constexpr bool isFreeNode(NodePtr index) const
+    {
+        return (freeBits[index / 64] >> (index % 64)) & 1;
+    }
+
+    /***** lowestFree *****/
+    /*------------------------------------------------------
+        Returns the lowest index of a recycled free node (a free node below
+        highWater), or NULL_VALUE if there is none: from the top word down, the
+        lowest set bit of each level gives the word to read in the level below,
+        and level 0 gives the node. Only the words below highWater are read.
+    -------------------------------------------------------*/
+    constexpr NodePtr lowestFree() const
+    {
+        if (highWater == 0)
+            return NULL_VALUE; // no word of the bitmap is in use yet
+        int top = BITMAP.levels - 1;
+        if (freeBits[BITMAP.offset[top]] == 0)
+            return NULL_VALUE;
+        int index = 0; // index of the word in the current level, then of the node
+        for (int level = top; level >= 0; level--)
+            index = index * 64 + lowestBit(freeBits[BITMAP.offset[level] + index]);
+        return index;
+    }
+
+    /***** relinkFreeList *****/
+    /*------------------------------------------------------
+        Rebuilds the free list of recycled nodes from the bitmap, in increasing
+        order of index (used when going back to LIFO_POLICY).
+    -------------------------------------------------------*/
+    constexpr void relinkFreeList()
+    {
+        NodePtr last = NULL_VALUE;
+        free = NULL_VALUE;
+        for (int i = 0; i < highWater; i++)
+        {
+            if (isFreeNode(i))
+            {
+                if (last == NULL_VALUE)
+                    free = i;
+                else
+                    arrNode[last].node.next = i;
+                last = i;
+            }
+        }
+        if (last != NULL_VALUE)
+            arrNode[last].node.next = NULL_VALUE;
+    }
+
+    /***** buildNode *****/
+    /*------------------------------------------------------
+        Builds the node of a slot handed out for the first time. If the elements
+        are allocator-aware (they accept a std::pmr::polymorphic_allocator) and the
+        pool has a memory resource, the data is built with uses-allocator
+        construction, so that everything the element allocates later comes from
+        the resource. Since a polymorphic allocator is never replaced by an
+        assignment, this holds for the whole life of the pool.
+    -------------------------------------------------------*/
+    constexpr void buildNode(NodePtr index)
+    {
+        std::construct_at(&arrNode[index].node);
+        typedef std::pmr::polymorphic_allocator<char> Allocator;
+        if constexpr (std::uses_allocator<ElementType, Allocator>::value)
+        {
+            if (resource != nullptr)
+            {
+                Allocator alloc(resource);
+                ElementType *data = &arrNode[index].node.data;
+                std::destroy_at(data); // destroy the default-built element...
+                // ...and rebuild it with the allocator (leading or trailing convention)
+                if constexpr (std::is_constructible<ElementType, std::allocator_arg_t, const Allocator &>::value)
+                    std::construct_at(data, std::allocator_arg, alloc);
+                else
+                    std::construct_at(data, alloc);
+            }
+        }
+    }
+
+    /***** buildAll *****/
+    /*------------------------------------------------------
+        Builds every node and clears every generation and bitmap word. Only used
+        during constant evaluation, where a constant cannot hold unbuilt nodes.
+    -------------------------------------------------------*/
+    constexpr void buildAll()
+    {
+        for (int i = 0; i < Capacity; i++)
+        {
+            buildNode(i);
+            generation[i] = 0;
+        }
+        for (int w = 0; w < BITMAP.offset[BITMAP.levels]; w++)
+            freeBits[w] = 0;
+        constructed = Capacity;
+    }
+
+    /***** copiedGeneration *****/
+    /*------------------------------------------------------
+        Generation of a node copied from a node of generation source over a node
+        of generation older: the smallest generation greater than both, with the
+        parity of source (odd: in use).
+    -------------------------------------------------------*/
+    constexpr static unsigned copiedGeneration(unsigned older, unsigned source)
+    {
+        unsigned next = (older > source ? older : source) + 1;
+        return (next % 2 == source % 2) ? next : next + 1;
+    }
+
+    /***** bumpNode *****/
+    /*------------------------------------------------------
+        Hands out the node at highWater, which was not handed out since the pool
+        was built or reset. It is built the first time; after a reset, the node
+        already built is reused and its generation moves to a new odd value, so
+        handles made before the reset stay stale. The bitmap words that the node
+        starts, in every level, are cleared, since they may hold bits from before
+        a reset (or nothing at all, as the constructor leaves them unwritten).
+    -------------------------------------------------------*/
+    constexpr NodePtr bumpNode()
+    {
+        NodePtr index = highWater++;
+        long long span = 64; // nodes covered by a word of the level
+        for (int level = 0; level < BITMAP.levels && index % span == 0; level++, span *= 64)
+            freeBits[BITMAP.offset[level] + index / span] = 0;
+        if (index < constructed)
+        {
+            generation[index] = (generation[index] + 2) | 1; // in use, and never used before
+        }
+        else
+        {
+            buildNode(index);
+            generation[index] = 1; // in use
+            constructed++;
+        }
+        return index;
+    }
 
 public:
     /***** Constructor *****/
     /*------------------------------------------------------
-        Initializes the storage pool linking all nodes together. Each node points
-        to the next one, and the last node point to NULL_VALUE indicating the end.
+        Initializes an empty storage pool in O(1): no node is built or linked yet.
+        The nodes are handed out in order of index, from highWater (a bump index),
+        until some are returned; the returned (recycled) nodes are then reused
+        first, through the free list. The part of the pool that is never used is
+        never written, so a pool with a large capacity costs nothing to build.
+        (During constant evaluation, every node is built at once, since a constant
+        cannot hold unbuilt nodes.)
 
         Precondition: None
-        Post-condition: Each node is linked to the next one, and free points to 0
-        indication that the first node in the pool is available.
+        Post-condition: Every node is free, highWater is 0 and the free list is empty
     -------------------------------------------------------*/
-    NodePool()
+    constexpr NodePool()
+        : free(NULL_VALUE), highWater(0), constructed(0), resource(nullptr), policy(LIFO_POLICY)
     {
-        for (int i = 0; i < NUM_NODES - 1; i++)
-        {                            // Loops through the array
-            arrNode[i].next = i + 1; // Links each node to the next one
-        }
+        if (std::is_constant_evaluated())
+            buildAll();
+    }
+
+    /***** Constructor (memory resource) *****/
+    /*------------------------------------------------------
+        Initializes the storage pool like the default constructor. If the elements
+        are allocator-aware, every node is built with memoryResource when it is
+        first handed out (see buildNode), so everything the elements allocate
+        comes from memoryResource.
 
-        arrNode[NUM_NODES - 1].next = NULL_VALUE; // Links the last node to NULL_VALUE
-                                                  // indicating the end of the newly
-                                                  // initialized linked list
-        free = 0;                                 // setting the first node as free
+        Precondition: memoryResource must outlive the pool
+        Post-condition: Same as the default constructor, and the elements use memoryResource
+    -------------------------------------------------------*/
+    explicit NodePool(std::pmr::memory_resource *memoryResource)
+        : free(NULL_VALUE), highWater(0), constructed(0), resource(memoryResource), policy(LIFO_POLICY) {}
+
+    /***** Copy Constructor / Assignment Operator *****/
+    /*------------------------------------------------------
+        Copy the nodes handed out by other (see cloneFrom). A new pool of
+        trivially copyable nodes keeps the implicit, trivial copy; an assignment
+        always goes through cloneFrom, so the handles of the assigned pool
+        become stale.
+    -------------------------------------------------------*/
+    NodePool(const NodePool &) requires std::is_trivially_copyable_v<NodeType> = default;
+
+    constexpr NodePool(const NodePool &other)
+        : free(NULL_VALUE), highWater(0), constructed(0), resource(nullptr), policy(LIFO_POLICY)
+    {
+        if (std::is_constant_evaluated())
+            buildAll();
+        cloneFrom(other);
+    }
+
+    constexpr NodePool &operator=(const NodePool &other)
+    {
+        cloneFrom(other);
+        return *this;
+    }
+
+    /***** Destructor *****/
+    /*------------------------------------------------------
+        Destroys the nodes that were built (nothing to do when the nodes are
+        trivially destructible).
+    -------------------------------------------------------*/
+    constexpr ~NodePool() requires std::is_trivially_destructible_v<NodeType> = default;
+
+    constexpr ~NodePool()
+    {
+        for (int i = 0; i < constructed; i++)
+        {
+            std::destroy_at(&arrNode[i].node);
+        }
     }
 
     /***** newnode *****/
@@ -89,19 +504,28 @@ public:
         Returns and allocates an index of the next free available node. And moves the free
         index to the next available node. Before allocating, it checks whether the storage pool is full.
         If the pool is full, NULL_VALUE is returned.
+        A recycled node is reused first (with LOWEST_INDEX_POLICY, the one with the lowest
+        index); when there is none, the node at highWater is handed out.
 
         Precondition: None (the function internally checks if the pool is full)
         Post-condition: Returns the index of the next free node.
     ---------------------------------------------------------------*/
 
-    int newNode()
+    constexpr int newNode()
     {
-        if (isFull()) 
+        if (isFull())
             return NULL_VALUE;     // Returns NULL_VALUE if no free nodes are available
+        if (free == NULL_VALUE)
+            return bumpNode(); // no recycled node: take a node never handed out
 
-        int index = free;          // Stores the index of the free node in a local variable
-        free = arrNode[free].next; // Moves the free pointer/index to the next node
-        return index;              // Returns the index of the newly allocated node
+        int index = free; // Stores the index of the free node in a local variable
+        markUsed(index);
+        if (policy == LIFO_POLICY)
+            free = arrNode[free].node.next; // Moves the free pointer/index to the next node
+        else
+            free = lowestFree(); // Moves the free index to the lowest recycled node
+        generation[index]++;     // The node is now in use (odd generation)
+        return index;            // Returns the index of the newly allocated node
     }
 
     /***** returnNode *****/
@@ -112,13 +536,271 @@ public:
      Post-Condition: The node in question is now the first free node
      -------------------------------------------------------------------------*/
 
-    void returnNode(NodePtr index)
+    constexpr void returnNode(NodePtr index)
     {
-        arrNode[index].next = free; // the node succeeding the node we want to free
-                                    // becomes the first free node
+        markFree(index);
+        generation[index]++; // handles to the node become stale (even generation)
+        if (policy == LOWEST_INDEX_POLICY)
+        {
+            if (free == NULL_VALUE || index < free)
+                free = index; // free is always the lowest free node
+            return;
+        }
+        arrNode[index].node.next = free; // the node succeeding the node we want to free
+                                         // becomes the first free node
         free = index; // the index of the node want to free/delete is assigned to free
     }
 
+    /***** cloneFrom *****/
+    /*-------------------------------------------------------------------------
+     Makes this storage pool an exact copy of another one: same nodes, same links
+     and same free list. Only the nodes handed out by other (below its highWater)
+     are copied; when they are trivially copyable, they are copied with one memcpy
+     instead of one assignment per node. Each copied node gets a generation newer
+     than both its own and the one of the node of other (see copiedGeneration), so
+     no handle made before the copy, in either pool, is current afterwards. The
+     nodes of this pool never built yet are built first (see buildNode), so the
+     copied elements still allocate from the memory resource of this pool.
+
+     Precondition: other is a valid storage pool of the same ElementType
+     Post-condition: Every node handed out, the free index and highWater are
+     identical to the ones of other
+     -------------------------------------------------------------------------*/
+    constexpr void cloneFrom(const NodePool &other)
+    {
+        if (this == &other)
+            return; // nothing to copy
+
+        int count = other.highWater; // the nodes never handed out hold nothing
+        if (std::is_trivially_copyable<NodeType>::value && !std::is_constant_evaluated())
+        {
+            std::memcpy(static_cast<void *>(arrNode), other.arrNode, count * sizeof(Slot)); // one bulk copy
+        }
+        else
+        {
+            // one assignment per node (also at compile time, where memcpy is not allowed)
+            for (int i = 0; i < count; i++)
+            {
+                if (i >= constructed)
+                    buildNode(i); // built with the resource of this pool, then assigned
+                arrNode[i].node = other.arrNode[i].node; // copies data and links of each node
+            }
+        }
+        for (int i = 0; i < count; i++)
+        {
+            unsigned older = (i < constructed) ? generation[i] : 0; // no generation yet: 0
+            generation[i] = copiedGeneration(older, other.generation[i]);
+        }
+        if (constructed < count)
+            constructed = count;
+        highWater = count;
+        free = other.free; // same first free node
+        policy = other.policy;
+        long long span = 64; // nodes covered by a word of the level
+        for (int level = 0; level < BITMAP.levels; level++, span *= 64)
+        {
+            int usedWords = int((count + span - 1) / span);
+            for (int w = BITMAP.offset[level]; w < BITMAP.offset[level] + usedWords; w++)
+                freeBits[w] = other.freeBits[w];
+        }
+    }
+
+    /***** separateGenerations *****/
+    /*-------------------------------------------------------------------------
+     Moves the generation of every node in use past the generation of the same
+     node of other, keeping it odd (see copiedGeneration), so that no handle
+     current in other is current in this pool. For a pool filled node by node
+     with copies of the nodes of other (cloneFrom does it by itself).
+
+     PreCondition: None
+     Post-Condition: The nodes in use keep being in use, with new generations
+     -------------------------------------------------------------------------*/
+    constexpr void separateGenerations(const NodePool &other)
+    {
+        int count = (highWater < other.constructed) ? highWater : other.constructed;
+        for (int i = 0; i < count; i++)
+        {
+            if (generation[i] % 2 == 1)
+                generation[i] = copiedGeneration(other.generation[i], generation[i]);
+        }
+    }
+
+    /***** returnChain *****/
+    /*-------------------------------------------------------------------------
+     Returns a chain of nodes, already linked together from head to tail, to the
+     free list with a single splice instead of one returnNode call per node.
+     The generation of every node of the chain is still incremented.
+
+     PreCondition: head..tail is a valid chain of nodes that are not in use
+     Post-Condition: head is the first free node, and tail is linked to the old first free node
+     -------------------------------------------------------------------------*/
+    constexpr void returnChain(NodePtr head, NodePtr tail)
+    {
+        for (NodePtr ptr = head; ptr != tail; ptr = arrNode[ptr].node.next)
+        {
+            generation[ptr]++; // handles to the node become stale
+            markFree(ptr);
+        }
+        generation[tail]++;
+        markFree(tail);
+        if (policy == LOWEST_INDEX_POLICY)
+        {
+            free = lowestFree(); // no free list to splice into
+            return;
+        }
+        arrNode[tail].node.next = free; // the old free list continues after the chain
+        free = head;               // the chain is now at the front of the free list
+    }
+
+    /***** allocateRun *****/
+    /*-------------------------------------------------------------------------
+     Allocates count free nodes that are next to each other in the array (indices
+     start, start + 1, ..., start + count - 1), the lowest such run being chosen. The run
+     may continue past highWater, where every node is free.
+     Filling consecutive nodes keeps a bulk insertion contiguous in memory.
+     The allocated nodes are not linked together.
+
+     PreCondition: count > 0
+     Post-Condition: Returns the index of the first node of the run, or NULL_VALUE
+     (and nothing is allocated) if there is no run of count free nodes
+     -------------------------------------------------------------------------*/
+    constexpr NodePtr allocateRun(int count)
+    {
+        NodePtr start = NULL_VALUE; // first node of the current run of free nodes
+        int length = 0;             // length of the current run
+        for (int i = 0; i < Capacity && length < count; i++)
+        {
+            if (i >= highWater)
+            {
+                // Every node from highWater on is free: the run ends there
+                if (length == 0)
+                    start = i;
+                length += (Capacity - i < count - length) ? Capacity - i : count - length;
+                break;
+            }
+            if (length == 0 && freeBits[i / 64] == 0)
+            {
+                // the whole word is in use: skip it (but not past highWater)
+                i = ((i / 64) * 64 + 63 < highWater) ? (i / 64) * 64 + 63 : highWater - 1;
+                continue;
+            }
+            if (isFreeNode(i))
+            {
+                if (length == 0)
+                    start = i;
+                length++;
+            }
+            else
+            {
+                length = 0;
+            }
+        }
+        if (length < count)
+            return NULL_VALUE; // no run long enough
+
+        for (NodePtr i = start; i < start + count; i++)
+        {
+            if (i == highWater)
+            {
+                bumpNode(); // never handed out (and neither are the next ones)
+                continue;
+            }
+            markUsed(i);
+            generation[i]++; // the node is now in use
+        }
+        if (policy == LOWEST_INDEX_POLICY)
+        {
+            free = lowestFree();
+            return start;
+        }
+        // Remove the nodes of the run from the free list
+        NodePtr ptr = free;
+        NodePtr pred = NULL_VALUE;
+        while (ptr != NULL_VALUE)
+        {
+            NodePtr next = arrNode[ptr].node.next;
+            if (ptr >= start && ptr < start + count)
+            {
+                if (pred == NULL_VALUE)
+                    free = next;
+                else
+                    arrNode[pred].node.next = next;
+            }
+            else
+            {
+                pred = ptr;
+            }
+            ptr = next;
+        }
+        return start;
+    }
+
+    /***** setPolicy / getPolicy *****/
+    /*-------------------------------------------------------------------------
+     Selects the allocation policy of the pool. It can be changed at any time:
+     going back to LIFO_POLICY rebuilds the free list in O(highWater).
+
+     PreCondition: None
+     Post-Condition: newNode follows the new policy
+     -------------------------------------------------------------------------*/
+    constexpr void setPolicy(AllocationPolicy newPolicy)
+    {
+        if (newPolicy == policy)
+            return;
+        policy = newPolicy;
+        if (policy == LIFO_POLICY)
+            relinkFreeList();
+        else
+            free = lowestFree();
+    }
+
+    constexpr AllocationPolicy getPolicy() const
+    {
+        return policy;
+    }
+
+    /***** countFree *****/
+    /*-------------------------------------------------------------------------
+     Returns the number of free nodes: the nodes never handed out, plus the
+     recycled ones (counting the bits of the bitmap below highWater).
+     -------------------------------------------------------------------------*/
+    constexpr int countFree() const
+    {
+        int count = Capacity - highWater;
+        for (int w = 0; w < (highWater + 63) / 64; w++)
+        {
+            count += countBits(freeBits[w]);
+        }
+        return count;
+    }
+
+    /***** reset *****/
+    /*-------------------------------------------------------------------------
+     Frees every node at once, in O(1): highWater goes back to 0 and the free list
+     is emptied. The nodes already built are not destroyed: they are reused as
+     they are handed out again, and their old data is overwritten by the next
+     user, like the data of any freed node. Every handle made before the reset
+     becomes stale.
+
+     PreCondition: The nodes are not used anymore (for example by a list)
+     Post-Condition: Every node is free, as after construction
+     -------------------------------------------------------------------------*/
+    constexpr void reset()
+    {
+        highWater = 0;
+        free = NULL_VALUE;
+    }
+
+    /***** getHighWater *****/
+    /*-------------------------------------------------------------------------
+     Returns the number of nodes handed out at least once since the pool was
+     built or reset: nodes [0, getHighWater()) are the only ones ever used.
+     -------------------------------------------------------------------------*/
+    constexpr int getHighWater() const
+    {
+        return highWater;
+    }
+
     /***** getNode *****/
     /*----------------------------------------------------------------
     This function returns the node with respect to its index. This function is used to access nodes,
@@ -127,9 +809,9 @@ public:
     Precondition: index must be valid which is always the case
     Post -condition: returns a reference to the node depending in its index
     ------------------------------------------------------------------*/
-    NodeType &getNode(int index)
+    constexpr NodeType &getNode(int index)
     {
-        return arrNode[index]; // Accesses the node in question and returns it
+        return arrNode[index].node; // Accesses the node in question and returns it
     }
     /***** getNode (const)*****/
     /*----------------------------------------------------------------
@@ -140,9 +822,30 @@ public:
     Post -condition: returns a reference to the node depending in its index
     ------------------------------------------------------------------*/
 
-    const NodeType &getNode(int index) const
+    constexpr const NodeType &getNode(int index) const
+    {
+        return arrNode[index].node;
+    }
+
+    /***** prefetchNode *****/
+    /*----------------------------------------------------------------
+    Asks the processor to start loading a node into the cache, without waiting
+    for it. A traversal calls it as soon as it knows the index of a node it will
+    visit soon, so the load overlaps with the work on the current node.
+
+    Precondition: None (NULL_VALUE is ignored)
+    Post-condition: Nothing observable; it is only a hint
+    ------------------------------------------------------------------*/
+    constexpr void prefetchNode(NodePtr index) const
     {
-        return arrNode[index];
+#if defined(__GNUC__) || defined(__clang__)
+        if (index != NULL_VALUE && !std::is_constant_evaluated())
+        {
+            __builtin_prefetch(&arrNode[index]);
+        }
+#else
+        (void)index;
+#endif
     }
     /***** getFree *****/
     /*-----------------------------------------------------------------
@@ -151,11 +854,52 @@ public:
     as it will be commented out.
 
     PreCondition: None
-    Post-Condition: returns the free index/pointer or NULL_VALUE if no free nodes
+    Post-Condition: returns the index of the next node newNode hands out (a recycled
+    node, or else highWater), or NULL_VALUE if no free nodes
+    ----------------------------------------------------------------------*/
+    constexpr int getFree() const
+    {
+        if (free != NULL_VALUE)
+            return free;
+        return highWater < Capacity ? highWater : NULL_VALUE;
+    }
+
+    /***** makeHandle *****/
+    /*-----------------------------------------------------------------
+    Returns a handle to a node in use, tagged with its current generation.
+
+    Precondition: index is a node in use
+    Post-condition: The handle is current until the node is freed
+    ----------------------------------------------------------------------*/
+    constexpr NodeHandle makeHandle(NodePtr index) const
+    {
+        NodeHandle handle = {index, generation[index]};
+        return handle;
+    }
+
+    /***** isCurrent *****/
+    /*-----------------------------------------------------------------
+    Checks that a handle refers to a node that is still in use, and that the
+    node was not freed (and maybe reused) since the handle was made.
+
+    Precondition: None
+    Post-condition: Returns true if the handle can be used safely
+    ----------------------------------------------------------------------*/
+    constexpr bool isCurrent(NodeHandle handle) const
+    {
+        return handle.index >= 0 && handle.index < highWater &&
+               generation[handle.index] == handle.generation &&
+               handle.generation % 2 == 1; // odd: the node is in use
+    }
+
+    /***** getResource *****/
+    /*-----------------------------------------------------------------
+    Returns the memory resource given at construction, or nullptr if the
+    elements use the global heap.
     ----------------------------------------------------------------------*/
-    int getFree() const
+    constexpr std::pmr::memory_resource *getResource() const
     {
-        return free;
+        return resource;
     }
 
     /***** isFull *****/
@@ -163,11 +907,12 @@ public:
      Checks whether the pool is full and out of free nodes.
 
      Precondition: Nonce
-     Post-Condition: Return true if free is NULL_VALUE, false otherwise
+     Post-Condition: Return true if there is no recycled node (free is NULL_VALUE)
+     and every node was handed out, false otherwise
      --------------------------------------------------------*/
-    bool isFull() const
+    constexpr bool isFull() const
     {
-        return free == NULL_VALUE; // Checks if free is equal to NULL and returns the result
+        return free == NULL_VALUE && highWater == Capacity;
     }
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,166 @@
+#ifndef POOLSTORAGE_H
+#define POOLSTORAGE_H
+
+/**--PoolStorage.h---------------------------------------------------------------------------
+    This header file places large pool-based objects (NodePool, ArrayBasedList, LruCache...)
+    in memory chosen for fast traversal. Since these objects keep all their nodes inside
+    themselves and link them with indices, the whole object can simply be built inside a
+    dedicated memory mapping:
+
+    - NORMAL_PAGES: ordinary 4 KiB pages.
+    - TRANSPARENT_HUGE_PAGES: the mapping is aligned on 2 MiB and marked with
+      madvise(MADV_HUGEPAGE), so the kernel backs it with 2 MiB pages when it can.
+    - EXPLICIT_HUGE_PAGES: the mapping uses MAP_HUGETLB (pages reserved by the
+      administrator in /proc/sys/vm/nr_hugepages). If none are available, it falls
+      back to transparent huge pages.
+
+    With huge pages, one TLB entry covers 512 times more nodes, so walking a pool of
+    millions of nodes should cause far fewer TLB misses. That reduction has not been
+    measured yet: bench/PoolTraversalBench.cpp reports the misses where hardware
+    counters are available, and bench/README.md gives the figures recorded so far. The mapping can also be bound to a NUMA
+    node (mbind), so the nodes live next to the threads that traverse them.
+
+    Basic Operations:
+    createPoolObject: Maps memory as requested and builds the object inside it
+    destroyPoolObject: Destroys an object built by createPoolObject and unmaps its memory
+
+    NOTE: Huge pages and NUMA binding are only available on Linux. Elsewhere, the object
+    is allocated with operator new and the options are ignored.
+-------------------------------------------------------------------------------------------*/
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Kind of pages backing a pool
+enum PageMode
+{
+    NORMAL_PAGES,
+    TRANSPARENT_HUGE_PAGES,
+    EXPLICIT_HUGE_PAGES
+};
+
+// Where and how to place a pool object
+struct StorageOptions
+{
+    PageMode pages; // kind of pages
+    int numaNode;   // NUMA node to bind the memory to, or -1 for no binding
+};
+
+const std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024; // Size of a (x86-64 / ARM64) huge page
+
+/***** mappingLength *****/
+/*--------------------------------------------------------------
+ Size of the mapping holding an object of the given size: rounded up to
+ a whole number of huge pages, so huge pages can back all of it.
+ --------------------------------------------------------------*/
+inline std::size_t mappingLength(std::size_t objectSize)
+{
+    return (objectSize + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+/***** mapPoolMemory *****/
+/*--------------------------------------------------------------
+ Maps length bytes as requested by options, before anything touches them
+ (pages are only placed when they are first written).
+
+ Precondition: length is a multiple of HUGE_PAGE_SIZE
+ Post-condition: Returns the start of the mapping (aligned on HUGE_PAGE_SIZE),
+ or nullptr if the memory could not be mapped or bound to the NUMA node
+ --------------------------------------------------------------*/
+inline void *mapPoolMemory(std::size_t length, const StorageOptions &options)
+{
+#if defined(__linux__)
+    void *memory = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    if (options.pages == EXPLICIT_HUGE_PAGES)
+    {
+        memory = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (memory == MAP_FAILED)
+    {
+        // Map one extra huge page, then trim the mapping so that it starts on a huge page
+        std::size_t padded = length + HUGE_PAGE_SIZE;
+        void *raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            return nullptr;
+        char *start = static_cast<char *>(raw);
+        char *aligned = reinterpret_cast<char *>(
+            (reinterpret_cast<std::size_t>(start) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+        if (aligned > start)
+            munmap(start, aligned - start); // before the aligned start
+        if (aligned + length < start + padded)
+            munmap(aligned + length, start + padded - (aligned + length)); // after the end
+        memory = aligned;
+#if defined(MADV_HUGEPAGE)
+        if (options.pages != NORMAL_PAGES)
+            madvise(memory, length, MADV_HUGEPAGE); // a hint: failure is not an error
+#endif
+    }
+
+    if (options.numaNode >= 0)
+    {
+        // mbind(MPOL_BIND) through syscall, so there is no dependency on libnuma
+        const int MPOL_BIND_MODE = 2;
+        unsigned long nodeMask = 1UL << options.numaNode;
+        if (options.numaNode >= int(8 * sizeof(nodeMask)) ||
+            syscall(SYS_mbind, memory, length, MPOL_BIND_MODE, &nodeMask, 8 * sizeof(nodeMask), 0) != 0)
+        {
+            munmap(memory, length);
+            return nullptr;
+        }
+    }
+    return memory;
+#else
+    (void)options;
+    return ::operator new(length, std::align_val_t(HUGE_PAGE_SIZE), std::nothrow);
+#endif
+}
+
+/***** createPoolObject *****/
+/*--------------------------------------------------------------
+ Builds an object (for example an ArrayBasedList<int, 4000000, 64>) inside
+ memory mapped as requested by options, passing args to its constructor.
+ The object is self-contained, so all of its nodes follow the options.
+
+ Precondition: None
+ Post-condition: Returns the new object, to be released with destroyPoolObject,
+ or nullptr if the memory could not be obtained
+ --------------------------------------------------------------*/
+template <typename PoolObject, typename... Args>
+PoolObject *createPoolObject(const StorageOptions &options, Args &&...args)
+{
+    void *memory = mapPoolMemory(mappingLength(sizeof(PoolObject)), options);
+    if (memory == nullptr)
+        return nullptr;
+    return ::new (memory) PoolObject(std::forward<Args>(args)...);
+}
+
+/***** destroyPoolObject *****/
+/*--------------------------------------------------------------
+ Destroys an object built by createPoolObject and releases its memory.
+
+ Precondition: object was returned by createPoolObject (or is nullptr)
+ Post-condition: The object is destroyed and its memory is unmapped
+ --------------------------------------------------------------*/
+template <typename PoolObject>
+void destroyPoolObject(PoolObject *object)
+{
+    if (object == nullptr)
+        return;
+    object->~PoolObject();
+#if defined(__linux__)
+    munmap(object, mappingLength(sizeof(PoolObject)));
+#else
+    ::operator delete(object, std::align_val_t(HUGE_PAGE_SIZE));
+#endif
+}
+
+#endif
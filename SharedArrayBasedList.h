@@ -0,0 +1,272 @@
+#ifndef SHAREDARRAYBASEDLIST_H
+#define SHAREDARRAYBASEDLIST_H
+
+/**--SharedArrayBasedList.h------------------------------------------------------------------
+    This template class places an ArrayBasedList in a named POSIX shared-memory segment,
+    so several processes can use the same list. Since the nodes of an ArrayBasedList are
+    linked by indices into its own storage pool, and not by pointers, the list is valid in
+    every process that maps the segment, whatever address it is mapped at. One process can
+    fill a list that other processes read in place (zero copy), instead of serializing it
+    through a pipe or a file.
+
+    The segment holds the list and a process-shared mutex. The mutex is robust: if a process
+    dies while holding it, the next process to lock it is told so and takes it over (the
+    list may then be half-modified, and a message is displayed).
+
+    Basic Operations:
+    Constructor: Creates a new segment (CREATE_SEGMENT) holding an empty list, or opens
+                 an existing one (OPEN_SEGMENT)
+    Destructor: Unmaps the segment; the segment itself stays until remove is called
+    isOpen: Tells whether the segment could be created or opened
+    read / write: Call a function with the list (read-only or not) while holding the mutex
+    remove: Deletes a named segment (the processes that mapped it keep their mapping)
+
+    NOTE: ElementType must be trivially copyable and must not contain pointers, since the
+    elements are read by other processes (ShortString can be used for short strings).
+    Every process must use the same ElementType and Capacity: the segment records a layout
+    tag (the type name of the list from typeid, the size and alignment of the element type,
+    Capacity, and a format version) and is rejected if it does not match, even for another
+    type of the same size (int and float).
+    POSIX only (shm_open, robust mutexes).
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// How SharedArrayBasedList obtains its segment
+enum SegmentMode
+{
+    CREATE_SEGMENT, // create a new segment (fails if the name is taken)
+    OPEN_SEGMENT    // open a segment created by another process
+};
+
+template <typename ElementType, int Capacity = NUM_NODES>
+class SharedArrayBasedList
+{
+    static_assert(is_trivially_copyable<ElementType>::value,
+                  "SharedArrayBasedList elements must be trivially copyable");
+    static_assert(atomic<uint32_t>::is_always_lock_free,
+                  "SharedArrayBasedList needs lock-free atomics in shared memory");
+
+private:
+    typedef ArrayBasedList<ElementType, Capacity> ListType;
+
+    /**--Segment--------------------------------------------------
+     Layout of the shared-memory segment.
+     ---------------------------------------------------------------**/
+    struct Segment
+    {
+        atomic<uint32_t> ready; // SEGMENT_MAGIC once the creator has initialized the rest
+        uint64_t size;          // sizeof(Segment), checked by the processes opening it
+        uint64_t layout;        // layoutTag(), checked by the processes opening it
+        pthread_mutex_t mutex;  // process-shared, robust
+        ListType list;          // the shared list
+    };
+
+    static const uint32_t SEGMENT_MAGIC = 0x4c495354; // "LIST"
+    static const uint64_t SEGMENT_VERSION = 2;        // changes with the layout of Segment (and NodePool)
+
+    /***** layoutTag *****/
+    /*-----------------------------------------------------------------------
+     FNV-1a hash of everything the layout of the segment depends on: the type
+     name of the list (typeid(ListType).name(), which names ElementType and
+     every other template argument, so int and float differ), the size and
+     alignment of ElementType, Capacity, sizeof(Segment) and SEGMENT_VERSION.
+     The type name is the mangled name of the C++ ABI, so processes built by
+     different compilers sharing that ABI (GCC, Clang) compute the same tag.
+     -----------------------------------------------------------------------*/
+    static uint64_t layoutTag()
+    {
+        const uint64_t PRIME = 1099511628211ull; // FNV prime
+        uint64_t tag = 14695981039346656037ull;  // FNV offset basis
+        for (const char *c = typeid(ListType).name(); *c != '\0'; c++)
+            tag = (tag ^ static_cast<unsigned char>(*c)) * PRIME;
+        uint64_t values[] = {sizeof(ElementType), alignof(ElementType), uint64_t(Capacity),
+                             sizeof(Segment), SEGMENT_VERSION};
+        for (uint64_t value : values)
+            tag = (tag ^ value) * PRIME;
+        return tag;
+    }
+
+    Segment *segment; // the mapped segment (nullptr if not open)
+
+    /***** Guard *****/
+    /*-----------------------------------------------------------------------
+     Holds the mutex of the segment for the lifetime of the object.
+     -----------------------------------------------------------------------*/
+    class Guard
+    {
+    private:
+        pthread_mutex_t *mutex;
+
+    public:
+        explicit Guard(pthread_mutex_t *m) : mutex(m)
+        {
+            if (pthread_mutex_lock(mutex) == EOWNERDEAD)
+            {
+                // The previous owner died while holding the mutex: take it over
+                cout << "A process died while modifying the shared list; it may be inconsistent" << endl;
+                pthread_mutex_consistent(mutex);
+            }
+        }
+        ~Guard() { pthread_mutex_unlock(mutex); }
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+    };
+
+    /***** create *****/
+    /*-----------------------------------------------------------------------
+     Creates the segment, builds the mutex and the empty list inside it, then
+     marks it ready for the other processes.
+     -----------------------------------------------------------------------*/
+    bool create(const string &name)
+    {
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0)
+            return false;
+        bool sized = ftruncate(fd, sizeof(Segment)) == 0;
+        void *memory = sized ? mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                             : MAP_FAILED;
+        close(fd); // the mapping stays valid
+        if (memory == MAP_FAILED)
+        {
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+        segment = static_cast<Segment *>(memory);
+        segment->size = sizeof(Segment);
+        segment->layout = layoutTag();
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&segment->mutex, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+        ::new (&segment->list) ListType(); // empty list, every node free
+        segment->ready.store(SEGMENT_MAGIC, memory_order_release);
+        return true;
+    }
+
+    /***** open *****/
+    /*-----------------------------------------------------------------------
+     Maps an existing segment, after checking its size, and waits (up to one
+     second) for its creator to finish initializing it.
+     -----------------------------------------------------------------------*/
+    bool open(const string &name)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        bool sized = fstat(fd, &info) == 0 && info.st_size == (off_t)sizeof(Segment);
+        void *memory = sized ? mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                             : MAP_FAILED;
+        close(fd);
+        if (memory == MAP_FAILED)
+            return false;
+
+        segment = static_cast<Segment *>(memory);
+        for (int attempt = 0; segment->ready.load(memory_order_acquire) != SEGMENT_MAGIC; attempt++)
+        {
+            if (attempt == 1000)
+            {
+                munmap(segment, sizeof(Segment));
+                segment = nullptr;
+                return false;
+            }
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        if (segment->size != sizeof(Segment) || segment->layout != layoutTag())
+        {
+            munmap(segment, sizeof(Segment)); // another ElementType or Capacity
+            segment = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+public:
+    /***** Constructor *****/
+    /*------------------------------------------------------
+        Creates or opens the named segment (a name like "/ingest-list").
+
+        Precondition: None
+        Post-condition: isOpen() tells whether the segment is usable. On failure,
+        an error message is displayed.
+    -------------------------------------------------------*/
+    SharedArrayBasedList(const string &name, SegmentMode mode) : segment(nullptr)
+    {
+        bool opened = (mode == CREATE_SEGMENT) ? create(name) : open(name);
+        if (!opened)
+        {
+            cout << "Shared list " << name << " could not be "
+                 << (mode == CREATE_SEGMENT ? "created" : "opened") << endl;
+        }
+    }
+
+    /***** Destructor *****/
+    /*------------------------------------------------------
+        Unmaps the segment. The list stays in the segment for the other
+        processes until remove is called.
+    -------------------------------------------------------*/
+    ~SharedArrayBasedList()
+    {
+        if (segment != nullptr)
+            munmap(segment, sizeof(Segment));
+    }
+
+    SharedArrayBasedList(const SharedArrayBasedList &) = delete;            // one mapping
+    SharedArrayBasedList &operator=(const SharedArrayBasedList &) = delete; // per object
+
+    bool isOpen() const
+    {
+        return segment != nullptr;
+    }
+
+    /***** read / write *****/
+    /*------------------------------------------------------
+        Call func with the shared list while holding the mutex of the segment,
+        and return what func returns. read gives a const list; write lets func
+        modify it. The list is used in place: nothing is copied.
+
+        Precondition: isOpen(); func must not keep references to the list
+        Post-condition: The mutex is released when func returns
+    -------------------------------------------------------*/
+    template <typename Function>
+    decltype(auto) read(Function func) const
+    {
+        Guard guard(&segment->mutex);
+        return func(static_cast<const ListType &>(segment->list));
+    }
+
+    template <typename Function>
+    decltype(auto) write(Function func)
+    {
+        Guard guard(&segment->mutex);
+        return func(segment->list);
+    }
+
+    /***** remove *****/
+    /*------------------------------------------------------
+        Deletes a named segment. It disappears once every process has unmapped it.
+        Returns true if the segment existed.
+    -------------------------------------------------------*/
+    static bool remove(const string &name)
+    {
+        return shm_unlink(name.c_str()) == 0;
+    }
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef STRINGPOLICIES_H
+#define STRINGPOLICIES_H
+
+/**--StringPolicies.h-------------------------------------------------------------------------
+    This header file provides comparison policies for lists of strings, to be given as
+    the KeyEqual (and Hash) template parameters of ArrayBasedList, for example:
+
+        ArrayBasedList<string, 100, 0, CaseInsensitiveEqual, CaseInsensitiveHash> names;
+        names.search("ALICE"); // finds "Alice", without building a string
+
+    Every policy takes its arguments as string_view, so it accepts string, const char*,
+    string_view and ShortString (through view()) alike, and is transparent: the list
+    accepts keys of any of these types and never builds a temporary string to compare.
+
+    Policies:
+    CaseInsensitiveEqual: Equal strings, ignoring the case of ASCII letters
+    CaseInsensitiveHash: Hash consistent with CaseInsensitiveEqual (for searchMany)
+    PrefixEqual: The element starts with the key (search("ab") finds "abc"); there is
+                 no hash consistent with it, so searchMany compares every key directly
+-------------------------------------------------------------------------------------------*/
+#include "InlineString.h"
+#include <cstddef>
+#include <string_view>
+
+/***** asView *****/
+/*--------------------------------------------------------------
+ Gives the characters of any supported string type as a string_view.
+ --------------------------------------------------------------*/
+constexpr std::string_view asView(std::string_view text)
+{
+    return text;
+}
+
+template <unsigned Capacity>
+constexpr std::string_view asView(const InlineString<Capacity> &text)
+{
+    return text.view();
+}
+
+/***** toLowerAscii *****/
+constexpr char toLowerAscii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+}
+
+/**--CaseInsensitiveEqual--------------------------------------------
+ Compares two strings ignoring the case of ASCII letters.
+ -----------------------------------------------------------------**/
+struct CaseInsensitiveEqual
+{
+    typedef void is_transparent;
+
+    template <typename Left, typename Right>
+    constexpr bool operator()(const Left &left, const Right &right) const
+    {
+        std::string_view a = asView(left), b = asView(right);
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); i++)
+        {
+            if (toLowerAscii(a[i]) != toLowerAscii(b[i]))
+                return false;
+        }
+        return true;
+    }
+};
+
+/**--CaseInsensitiveHash---------------------------------------------
+ FNV-1a hash of the lowercase characters: strings that differ only by
+ case get the same hash.
+ -----------------------------------------------------------------**/
+struct CaseInsensitiveHash
+{
+    typedef void is_transparent;
+
+    template <typename Text>
+    constexpr std::size_t operator()(const Text &text) const
+    {
+        std::size_t h = 2166136261u; // FNV offset basis
+        for (char c : asView(text))
+        {
+            h ^= static_cast<unsigned char>(toLowerAscii(c));
+            h *= 16777619u; // FNV prime
+        }
+        return h;
+    }
+};
+
+/**--PrefixEqual-----------------------------------------------------
+ Matches an element that starts with the key (the first argument is
+ the element, the second the key).
+ -----------------------------------------------------------------**/
+struct PrefixEqual
+{
+    typedef void is_transparent;
+
+    template <typename Element, typename Key>
+    constexpr bool operator()(const Element &element, const Key &key) const
+    {
+        return asView(element).substr(0, asView(key).size()) == asView(key);
+    }
+};
+
+#endif
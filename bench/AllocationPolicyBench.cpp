@@ -0,0 +1,50 @@
+/**--AllocationPolicyBench.cpp--------------------------------------------------------------
+    Measures the cost of a node allocation with each AllocationPolicy in a large pool:
+    a list of ArrayBasedList<int, 4000000> is filled with n elements, then deleteFirst and
+    insertFirst are repeated, so every insertion reuses the node just freed and newNode
+    then looks for the next free node (with LOWEST_INDEX_POLICY, in the free bitmap).
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. bench/AllocationPolicyBench.cpp -o allocation_bench
+        ./allocation_bench
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+using namespace std;
+
+const int CAPACITY = 4000000;
+const int OPERATIONS = 200000;
+
+/***** measure *****/
+void measure(int size, AllocationPolicy policy)
+{
+    auto list = make_unique<ArrayBasedList<int, CAPACITY>>();
+    cout.setstate(ios::failbit); // the list reports every operation
+    for (int i = 0; i < size; i++)
+        list->insertLast(i);
+    list->setAllocationPolicy(policy);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < OPERATIONS; i++)
+    {
+        list->deleteFirst();
+        list->insertFirst(i);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    cout.clear();
+    printf("%-12s %8d elements  %6.0f ns per deleteFirst + insertFirst\n",
+           policy == LIFO_POLICY ? "LIFO" : "LOWEST_INDEX", size, ns / OPERATIONS);
+}
+
+int main()
+{
+    for (AllocationPolicy policy : {LIFO_POLICY, LOWEST_INDEX_POLICY})
+    {
+        measure(4000, policy);
+        measure(400000, policy);
+        measure(3900000, policy);
+    }
+    return 0;
+}
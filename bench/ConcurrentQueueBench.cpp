@@ -0,0 +1,167 @@
+/**--ConcurrentQueueBench.cpp----------------------------------------------------------------
+    Compares ConcurrentQueue with a std::deque guarded by a std::mutex (bounded to the same
+    capacity), with P producer and C consumer threads moving N elements, and single-threaded
+    (enqueue 512 then dequeue 512, one by one and in batches).
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -pthread -I. bench/ConcurrentQueueBench.cpp -o queue_bench
+        ./queue_bench [producers] [consumers] [elements]    (default: 4 4 4000000)
+
+    The contended figures only mean something when there are at least P + C cores: with
+    fewer, the threads take turns on the same cores and the run mostly measures the
+    scheduler. The program prints the number of hardware threads it sees.
+-------------------------------------------------------------------------------------------*/
+#include "ConcurrentQueue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const int CAPACITY = 1024;
+
+/**--MutexQueue--------------------------------------------------
+ The baseline: a bounded std::deque behind one mutex.
+ ---------------------------------------------------------------**/
+class MutexQueue
+{
+private:
+    mutex lock;
+    deque<long> items;
+
+public:
+    bool tryEnqueue(long value)
+    {
+        lock_guard<mutex> guard(lock);
+        if (items.size() >= size_t(CAPACITY))
+            return false;
+        items.push_back(value);
+        return true;
+    }
+
+    bool tryDequeue(long &value)
+    {
+        lock_guard<mutex> guard(lock);
+        if (items.empty())
+            return false;
+        value = items.front();
+        items.pop_front();
+        return true;
+    }
+};
+
+/***** contended *****/
+/*------------------------------------------------------
+    Moves elements 0..count-1 from the producers to the consumers and
+    returns the time per element in ns (the sum checks that nothing is
+    lost or duplicated).
+-------------------------------------------------------*/
+template <typename Queue>
+double contended(Queue &queue, int producers, int consumers, long count)
+{
+    atomic<long> sum(0), received(0);
+    vector<thread> threads;
+    auto start = chrono::steady_clock::now();
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]
+                             {
+                                 for (long i = p; i < count; i += producers)
+                                 {
+                                     while (!queue.tryEnqueue(i))
+                                         this_thread::yield();
+                                 } });
+    }
+    for (int c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&]
+                             {
+                                 long value, local = 0;
+                                 while (received.load(memory_order_relaxed) < count)
+                                 {
+                                     if (queue.tryDequeue(value))
+                                     {
+                                         local += value;
+                                         received.fetch_add(1, memory_order_relaxed);
+                                     }
+                                 }
+                                 sum += local; });
+    }
+    for (thread &t : threads)
+        t.join();
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    if (sum.load() != count * (count - 1) / 2)
+        printf("checksum mismatch\n");
+    return ns / count;
+}
+
+/***** uncontended *****/
+/*------------------------------------------------------
+    One thread enqueues then dequeues 512 elements, many times; returns
+    the time per operation in ns.
+-------------------------------------------------------*/
+template <typename Queue>
+double uncontended(Queue &queue)
+{
+    const int ROUNDS = 40000, BURST = 512;
+    long value = 0, sum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (int i = 0; i < BURST; i++)
+            queue.tryEnqueue(i);
+        for (int i = 0; i < BURST; i++)
+        {
+            queue.tryDequeue(value);
+            sum += value;
+        }
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    if (sum != long(ROUNDS) * BURST * (BURST - 1) / 2)
+        printf("checksum mismatch\n");
+    return ns / (2.0 * ROUNDS * BURST);
+}
+
+/***** uncontendedBatch *****/
+double uncontendedBatch(ConcurrentQueue<long, CAPACITY> &queue)
+{
+    const int ROUNDS = 40000, BURST = 512;
+    long items[BURST], results[BURST];
+    for (int i = 0; i < BURST; i++)
+        items[i] = i;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        queue.enqueueBatch(items, BURST);
+        queue.dequeueBatch(results, BURST);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    return ns / (2.0 * ROUNDS * BURST);
+}
+
+int main(int argc, char *argv[])
+{
+    int producers = argc > 1 ? atoi(argv[1]) : 4;
+    int consumers = argc > 2 ? atoi(argv[2]) : 4;
+    long count = argc > 3 ? atol(argv[3]) : 4000000;
+    unsigned cores = thread::hardware_concurrency();
+
+    static ConcurrentQueue<long, CAPACITY> lockFree; // too large for the stack
+    static MutexQueue locked;
+
+    printf("hardware threads: %u, producers: %d, consumers: %d, elements: %ld\n",
+           cores, producers, consumers, count);
+    if (cores < unsigned(producers + consumers))
+        printf("fewer cores than threads: the contended figures mostly measure the scheduler\n");
+    printf("contended    lock-free %7.1f ns/element   mutex+deque %7.1f ns/element\n",
+           contended(lockFree, producers, consumers, count), contended(locked, producers, consumers, count));
+    printf("uncontended  lock-free %7.1f ns/op        mutex+deque %7.1f ns/op\n",
+           uncontended(lockFree), uncontended(locked));
+    printf("uncontended  lock-free batches %7.1f ns/op\n", uncontendedBatch(lockFree));
+    return 0;
+}
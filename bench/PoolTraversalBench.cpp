@@ -0,0 +1,150 @@
+/**--PoolTraversalBench.cpp-----------------------------------------------------------------
+    Measures a pointer chase through a large NodePool whose nodes are linked in a random
+    order, so that nearly every hop touches another page. It compares normal pages with
+    transparent huge pages, and the natural node stride with a 64-byte (cache line) stride.
+    For every configuration it reports the time per hop and, when the kernel allows it, the
+    data-TLB load misses per hop (read with perf_event_open, as
+    perf stat -e dTLB-load-misses would).
+
+    Build and run (from the repository root, Linux):
+        g++ -std=c++20 -O2 -I. bench/PoolTraversalBench.cpp -o traversal_bench
+        ./traversal_bench
+
+    When the hardware counter is not available (no PMU in a virtual machine, or
+    /proc/sys/kernel/perf_event_paranoid too high), "n/a" is printed instead of the misses.
+-------------------------------------------------------------------------------------------*/
+#include "PoolStorage.h"
+#include "NodePool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const int NODES = 4000000; // 4M int nodes: 32 MB with the natural stride, 256 MB with 64 bytes
+const int PASSES = 3;
+
+/**--TlbCounter--------------------------------------------------
+ Counts the data-TLB load misses of this thread between start and
+ stop, or reports that the counter could not be opened.
+ ---------------------------------------------------------------**/
+class TlbCounter
+{
+private:
+    int fd;
+
+public:
+    TlbCounter() : fd(-1)
+    {
+#if defined(__linux__)
+        perf_event_attr attr = {};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~TlbCounter()
+    {
+#if defined(__linux__)
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    void start()
+    {
+#if defined(__linux__)
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    uint64_t stop()
+    {
+        uint64_t count = 0;
+#if defined(__linux__)
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != ssize_t(sizeof(count)))
+                count = 0;
+        }
+#endif
+        return count;
+    }
+};
+
+/***** chase *****/
+/*------------------------------------------------------
+    Builds a pool with the given stride and pages, links its nodes in a
+    random order, then follows the links PASSES times.
+-------------------------------------------------------*/
+template <size_t NodeAlignment>
+void chase(const char *name, PageMode pages)
+{
+    typedef NodePool<int, NODES, NodeAlignment> Pool;
+    Pool *pool = createPoolObject<Pool>(StorageOptions{pages, -1});
+    if (pool == nullptr)
+    {
+        printf("%-28s could not be mapped\n", name);
+        return;
+    }
+    vector<NodePtr> order(NODES);
+    for (int i = 0; i < NODES; i++)
+        order[i] = pool->newNode(); // every node, in index order
+    mt19937 generator(1);
+    shuffle(order.begin(), order.end(), generator);
+    for (int i = 0; i < NODES; i++)
+        pool->getNode(order[i]).next = (i + 1 < NODES) ? order[i + 1] : NULL_VALUE;
+
+    TlbCounter tlb;
+    long sum = 0;
+    tlb.start();
+    auto begin = chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++)
+    {
+        for (NodePtr ptr = order[0]; ptr != NULL_VALUE; ptr = pool->getNode(ptr).next)
+            sum += ptr;
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - begin).count();
+    uint64_t misses = tlb.stop();
+    double hops = double(PASSES) * NODES;
+
+    if (tlb.available())
+        printf("%-28s %7.1f ns/hop   %6.3f dTLB misses/hop\n", name, ns / hops, misses / hops);
+    else
+        printf("%-28s %7.1f ns/hop   n/a dTLB misses/hop\n", name, ns / hops);
+    if (sum == 42)
+        printf("\n"); // keeps the traversal from being optimized away
+    destroyPoolObject(pool);
+}
+
+int main()
+{
+    chase<0>("normal pages, natural stride", NORMAL_PAGES);
+    chase<0>("THP, natural stride", TRANSPARENT_HUGE_PAGES);
+    chase<64>("normal pages, 64-byte stride", NORMAL_PAGES);
+    chase<64>("THP, 64-byte stride", TRANSPARENT_HUGE_PAGES);
+    chase<0>("explicit huge pages, natural", EXPLICIT_HUGE_PAGES);
+    return 0;
+}
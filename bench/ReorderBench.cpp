@@ -0,0 +1,70 @@
+/**--ReorderBench.cpp-----------------------------------------------------------------------
+    Measures the self-organizing lists on skewed lookups: 1000 distinct keys in a random
+    order, then 1M searches drawn from a Zipf distribution (exponent s), with every
+    ReorderPolicy. Reports the average number of hops per search (position + 1) and the
+    total time. Also prints the size of a list with and without access counters.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. bench/ReorderBench.cpp -o reorder_bench
+        ./reorder_bench
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+const int KEYS = 1000;
+const int LOOKUPS = 1000000;
+
+typedef ArrayBasedList<int, KEYS, 0, equal_to<>, hash<int>, true> CountingList; // COUNT_ORDER needs counters
+
+int main()
+{
+    printf("sizeof ArrayBasedList<int, 1000000>: %zu bytes without counters, %zu with\n",
+           sizeof(ArrayBasedList<int, 1000000>),
+           sizeof(ArrayBasedList<int, 1000000, 0, equal_to<>, hash<int>, true>));
+
+    const char *names[] = {"none", "move-to-front", "transpose", "count"};
+    ReorderPolicy policies[] = {NO_REORDER, MOVE_TO_FRONT, TRANSPOSE, COUNT_ORDER};
+    for (double s : {0.8, 1.0, 1.2})
+    {
+        // The trace: Zipf ranks mapped to keys in a random order
+        mt19937 generator(5);
+        vector<double> weights(KEYS);
+        for (int i = 0; i < KEYS; i++)
+            weights[i] = 1.0 / pow(i + 1, s);
+        discrete_distribution<int> zipf(weights.begin(), weights.end());
+        vector<int> keyOfRank(KEYS), insertionOrder(KEYS);
+        for (int i = 0; i < KEYS; i++)
+            keyOfRank[i] = insertionOrder[i] = i;
+        shuffle(keyOfRank.begin(), keyOfRank.end(), generator);
+        shuffle(insertionOrder.begin(), insertionOrder.end(), generator);
+        vector<int> trace(LOOKUPS);
+        for (int &key : trace)
+            key = keyOfRank[zipf(generator)];
+
+        for (ReorderPolicy policy : policies)
+        {
+            auto list = make_unique<CountingList>();
+            cout.setstate(ios::failbit); // the list reports every insertion
+            for (int key : insertionOrder)
+                list->insertLast(key);
+            cout.clear();
+            list->setReorderPolicy(policy);
+
+            double hops = 0;
+            auto start = chrono::steady_clock::now();
+            for (int key : trace)
+                hops += list->search(key) + 1;
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            printf("zipf s=%.1f  %-14s %7.1f hops/search  %6.0f ms\n", s, names[policy], hops / LOOKUPS, ms);
+        }
+    }
+    return 0;
+}
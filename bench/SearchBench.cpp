@@ -0,0 +1,93 @@
+/**--SearchBench.cpp------------------------------------------------------------------------
+    Measures the searches on a list of 4M int nodes linked in a random order (the nodes
+    are freed in a random order, then taken again by insertLast), so that every hop is a
+    cache miss. A full walk from the tail along the prev links (forEachReverse), one
+    cursor, is the baseline of a search that walks from one end. It is compared with
+    search, which walks from both ends at once (a miss, a hit in the middle, a hit near
+    the tail), and with searchMany against one search per key. Also times insertAtPos and
+    deleteAtPos at a quarter of the list, which find their position with a single cursor.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. bench/SearchBench.cpp -o search_bench
+        ./search_bench
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+const int NODES = 4000000;
+const int PASSES = 3;
+
+typedef ArrayBasedList<int, NODES> List;
+
+/***** milliseconds *****/
+template <typename Function>
+double milliseconds(Function run)
+{
+    auto start = chrono::steady_clock::now();
+    run();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    auto list = make_unique<List>();
+    cout.setstate(ios::failbit); // the list reports every operation
+    vector<NodeHandle> handles(NODES);
+    for (int i = 0; i < NODES; i++)
+        handles[i] = list->insertLast(i);
+    mt19937 generator(3);
+    shuffle(handles.begin(), handles.end(), generator);
+    for (NodeHandle handle : handles) // LIFO free list: the nodes come back in a random order
+        list->erase(handle);
+    for (int i = 0; i < NODES; i++)
+        list->insertLast(i);
+
+    long checksum = 0;
+    double ms = milliseconds([&]
+                             { for (int pass = 0; pass < PASSES; pass++)
+                                   list->forEachReverse([&](int value) { checksum += value; }); });
+    printf("one cursor, full walk        %7.1f ms\n", ms / PASSES);
+    struct
+    {
+        const char *name;
+        int key;
+    } searches[] = {{"search, miss", -1}, {"search, middle", NODES / 2}, {"search, 9/10 of the list", NODES / 10 * 9}};
+    for (auto &run : searches)
+    {
+        ms = milliseconds([&]
+                          { for (int pass = 0; pass < PASSES; pass++)
+                                checksum += list->search(run.key); });
+        printf("%-28s %7.1f ms\n", run.name, ms / PASSES);
+    }
+
+    for (int keyCount : {4, 16})
+    {
+        vector<int> keys(keyCount);
+        for (int &key : keys)
+            key = int(generator() % (2 * NODES)); // about half of them are missing
+        double separate = milliseconds([&]
+                                       { for (int key : keys)
+                                             checksum += list->search(key); });
+        double together = milliseconds([&]
+                                       { checksum += list->searchMany(keys)[0]; });
+        printf("%2d keys: %2d searches %7.1f ms, searchMany %7.1f ms\n", keyCount, keyCount, separate, together);
+    }
+
+    ms = milliseconds([&]
+                      { for (int pass = 0; pass < PASSES; pass++)
+                        {
+                            list->deleteAtPos(NODES / 4);
+                            list->insertAtPos(7, NODES / 4);
+                        } });
+    printf("deleteAtPos + insertAtPos at size/4  %7.1f ms\n", ms / PASSES);
+    cout.clear();
+    printf("(checksum %ld)\n", checksum % 2);
+    return 0;
+}
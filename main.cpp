@@ -159,9 +159,7 @@ int main()
 
             case 3:
                 cout << "List in Reverse:\n";
-                csisList.reverse(); // Reverse the list
-                cout << csisList;   // Print reversed list
-                csisList.reverse(); // Reverse again to restore original order
+                csisList.rdisplay(cout); // Print the list from tail to head
                 break;
 
             default:
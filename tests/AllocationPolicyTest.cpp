@@ -0,0 +1,284 @@
+/**--AllocationPolicyTest.cpp---------------------------------------------------------------
+    Tests of the node allocation of NodePool: random newNode, returnNode, returnChain,
+    allocateRun, reset, copy and setPolicy calls are applied both to a pool and to a simple
+    model of each AllocationPolicy, and the pool must always hand out the node the model
+    expects. The capacities give free bitmaps of 2, 3 and 4 levels. Lists must also keep
+    their allocation policy through every kind of copy, and keep the same elements as a
+    vector model while the policy changes.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/AllocationPolicyTest.cpp -o allocation_test && ./allocation_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**--PoolModel--------------------------------------------------
+ The free nodes of a pool: the nodes never handed out (from
+ highWater on), the recycled ones, and the order of the free list.
+ ---------------------------------------------------------------**/
+struct PoolModel
+{
+    int capacity;
+    int highWater;
+    set<int> recycled;    // free nodes below highWater
+    vector<int> freeList; // LIFO_POLICY: the recycled nodes, first to be reused first
+    AllocationPolicy policy;
+
+    int next() const // the node newNode hands out next
+    {
+        if (!recycled.empty())
+            return (policy == LIFO_POLICY) ? freeList.front() : *recycled.begin();
+        return highWater < capacity ? highWater : NULL_VALUE;
+    }
+
+    int allocate()
+    {
+        int index = next();
+        if (index == highWater)
+            highWater++;
+        else if (index != NULL_VALUE)
+            release(index);
+        return index;
+    }
+
+    void release(int index) // index leaves the free nodes
+    {
+        recycled.erase(index);
+        freeList.erase(find(freeList.begin(), freeList.end(), index));
+    }
+
+    void free(const vector<int> &chain) // the chain is returned in one piece
+    {
+        recycled.insert(chain.begin(), chain.end());
+        freeList.insert(freeList.begin(), chain.begin(), chain.end());
+    }
+
+    int lowestRun(int count) const
+    {
+        for (int start = 0; start + count <= capacity; start++)
+        {
+            int i = start;
+            while (i < start + count && (i >= highWater || recycled.count(i)))
+                i++;
+            if (i == start + count)
+                return start;
+        }
+        return NULL_VALUE;
+    }
+
+    void setPolicy(AllocationPolicy newPolicy)
+    {
+        if (newPolicy == LIFO_POLICY && policy != LIFO_POLICY)
+            freeList.assign(recycled.begin(), recycled.end()); // rebuilt in increasing order
+        policy = newPolicy;
+    }
+};
+
+/***** testPoolAgainstModel *****/
+template <int Capacity>
+void testPoolAgainstModel(mt19937 &generator, int steps)
+{
+    typedef NodePool<int, Capacity> Pool;
+    auto first = make_unique<Pool>(), second = make_unique<Pool>();
+    Pool *pool = first.get(), *spare = second.get(); // copies go back and forth
+    PoolModel model = {Capacity, 0, {}, {}, LIFO_POLICY};
+    vector<int> used; // nodes in use
+    for (int step = 0; step < steps; step++)
+    {
+        int operation = generator() % 100;
+        if (operation < 45)
+        {
+            int expected = model.allocate();
+            int index = pool->newNode();
+            assert(index == expected);
+            if (index != NULL_VALUE)
+                used.push_back(index);
+        }
+        else if (operation < 85 && !used.empty())
+        {
+            int count = 1 + generator() % min<int>(int(used.size()), 8);
+            vector<int> chain;
+            for (int k = 0; k < count; k++)
+            {
+                size_t pick = generator() % used.size();
+                chain.push_back(used[pick]);
+                used[pick] = used.back();
+                used.pop_back();
+            }
+            if (count == 1)
+            {
+                pool->returnNode(chain[0]);
+            }
+            else
+            {
+                for (int k = 0; k + 1 < count; k++)
+                    pool->getNode(chain[k]).next = chain[k + 1];
+                pool->returnChain(chain.front(), chain.back());
+            }
+            model.free(chain);
+        }
+        else if (operation < 92)
+        {
+            int count = 1 + generator() % 70;
+            int expected = model.lowestRun(count);
+            int start = pool->allocateRun(count);
+            assert(start == expected);
+            if (start != NULL_VALUE)
+            {
+                for (int i = start; i < start + count; i++)
+                {
+                    if (i >= model.highWater)
+                        model.highWater = i + 1;
+                    else
+                        model.release(i);
+                    used.push_back(i);
+                }
+            }
+        }
+        else if (operation < 97)
+        {
+            AllocationPolicy policy = (generator() % 2) ? LIFO_POLICY : LOWEST_INDEX_POLICY;
+            pool->setPolicy(policy);
+            model.setPolicy(policy);
+        }
+        else if (operation < 99)
+        {
+            *spare = *pool; // the copy allocates exactly like the original
+            swap(pool, spare);
+        }
+        else if (generator() % 4 == 0)
+        {
+            pool->reset();
+            model.highWater = 0;
+            model.recycled.clear();
+            model.freeList.clear();
+            used.clear();
+        }
+        assert(pool->getPolicy() == model.policy);
+        assert(pool->getHighWater() == model.highWater);
+        assert(pool->getFree() == model.next());
+        assert(pool->countFree() == Capacity - model.highWater + int(model.recycled.size()));
+    }
+}
+
+/***** testLargePool *****/
+/*------------------------------------------------------
+    With LOWEST_INDEX_POLICY, freeing nodes scattered over a pool with a
+    4-level bitmap must hand them back in increasing order.
+-------------------------------------------------------*/
+void testLargePool()
+{
+    typedef NodePool<int, 300000> Pool;
+    auto pool = make_unique<Pool>();
+    pool->setPolicy(LOWEST_INDEX_POLICY);
+    for (int i = 0; i < 300000; i++)
+        pool->newNode();
+    int freed[] = {299999, 4095, 262144, 4096, 17, 262143};
+    for (int index : freed)
+        pool->returnNode(index);
+    sort(begin(freed), end(freed));
+    for (int index : freed)
+    {
+        int allocated = pool->newNode();
+        assert(allocated == index);
+    }
+    int allocated = pool->newNode();
+    assert(allocated == NULL_VALUE && pool->countFree() == 0);
+}
+
+/***** contents *****/
+template <typename ElementType, int Capacity>
+vector<ElementType> contents(const ArrayBasedList<ElementType, Capacity> &list)
+{
+    vector<ElementType> items;
+    list.forEachReverse([&](const ElementType &item)
+                        { items.insert(items.begin(), item); });
+    return items;
+}
+
+/***** testListCopies *****/
+/*------------------------------------------------------
+    Every copy of a list keeps its allocation policy, whether the elements
+    are trivially copyable or not, and whether the list is empty or not.
+-------------------------------------------------------*/
+template <typename ElementType>
+void testListCopies(const ElementType &item)
+{
+    typedef ArrayBasedList<ElementType, 20> List;
+    auto source = make_unique<List>();
+    source->setAllocationPolicy(LOWEST_INDEX_POLICY);
+    for (int filled = 0; filled < 2; filled++)
+    {
+        List copy(*source);
+        assert(copy.getAllocationPolicy() == LOWEST_INDEX_POLICY);
+        List assigned;
+        assigned = *source;
+        assert(assigned.getAllocationPolicy() == LOWEST_INDEX_POLICY);
+        assert(contents(copy) == contents(*source) && contents(assigned) == contents(*source));
+        source->insertLast(item);
+        source->insertLast(item);
+    }
+}
+
+/***** testListAgainstModel *****/
+/*------------------------------------------------------
+    Insertions and deletions anywhere while the policy changes: the list
+    must hold the same elements as a vector.
+-------------------------------------------------------*/
+void testListAgainstModel(mt19937 &generator)
+{
+    typedef ArrayBasedList<string, 200> List;
+    auto list = make_unique<List>();
+    vector<string> model;
+    for (int step = 0; step < 20000; step++)
+    {
+        int operation = generator() % 10;
+        int size = int(model.size());
+        string value = to_string(generator() % 1000);
+        if (operation < 4 && size < 200)
+        {
+            unsigned pos = generator() % (size + 1);
+            list->insertAtPos(value, pos);
+            model.insert(model.begin() + pos, value);
+        }
+        else if (operation < 8 && size > 0)
+        {
+            unsigned pos = generator() % size;
+            list->deleteAtPos(pos);
+            model.erase(model.begin() + pos);
+        }
+        else if (operation == 8)
+        {
+            list->setAllocationPolicy((generator() % 2) ? LIFO_POLICY : LOWEST_INDEX_POLICY);
+        }
+        else
+        {
+            List copy(*list);
+            *list = copy;
+        }
+        assert(contents(*list) == model);
+    }
+}
+
+int main()
+{
+    mt19937 generator(7);
+    testPoolAgainstModel<300>(generator, 50000);   // 2 bitmap levels
+    testPoolAgainstModel<5000>(generator, 100000); // 3 bitmap levels
+    testLargePool();                               // 4 bitmap levels
+    cout.setstate(ios::failbit); // the lists report every operation
+    testListCopies<int>(1);
+    testListCopies<string>("a string too long to be stored inline");
+    testListAgainstModel(generator);
+    cout.clear();
+    cout << "AllocationPolicy tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,235 @@
+/**--BatchTest.cpp--------------------------------------------------------------------------
+    Tests of the batch operations of ArrayBasedList: random batches (insertions and deletions
+    at the same original positions, insertions at size, invalid batches) are applied both to a
+    list and to a vector model, with both allocation policies, as are removeIf and removeAll.
+    A rejected batch must leave the list unchanged, the deleted nodes must go back to the pool
+    (and be reused by the insertions of the same batch), and their handles must go stale.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/BatchTest.cpp -o batch_test && ./batch_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+const int CAPACITY = 48;
+typedef ArrayBasedList<int, CAPACITY> List;
+typedef List::Edit Edit;
+
+/***** contents *****/
+vector<int> contents(const List &list)
+{
+    vector<int> items;
+    list.forEachReverse([&](int item)
+                        { items.insert(items.begin(), item); });
+    return items;
+}
+
+/***** checkList *****/
+/*------------------------------------------------------
+    The list holds the model, in both directions (the elements are
+    distinct, so search gives the position through the next links).
+-------------------------------------------------------*/
+void checkList(const List &list, const vector<int> &model)
+{
+    assert(list.getsize() == int(model.size()) && contents(list) == model);
+    for (size_t i = 0; i < model.size(); i++)
+        assert(list.searchNoReorder(model[i]) == int(i));
+}
+
+/***** applyToModel *****/
+/*------------------------------------------------------
+    What applyBatch must do: before each original element (and at the end),
+    the insertions at its position in the given order, then the element
+    unless it is deleted. Returns false for a batch that must be rejected.
+-------------------------------------------------------*/
+bool applyToModel(vector<int> &model, const vector<Edit> &edits)
+{
+    int size = int(model.size());
+    vector<bool> deleted(size, false);
+    int insertions = 0, deletions = 0;
+    for (const Edit &edit : edits)
+    {
+        if (edit.kind == List::INSERT_EDIT)
+        {
+            if (int(edit.pos) > size)
+                return false;
+            insertions++;
+        }
+        else
+        {
+            if (int(edit.pos) >= size || deleted[edit.pos])
+                return false;
+            deleted[edit.pos] = true;
+            deletions++;
+        }
+    }
+    if (size + insertions - deletions > CAPACITY)
+        return false;
+    vector<int> result;
+    for (int pos = 0; pos <= size; pos++)
+    {
+        for (const Edit &edit : edits)
+        {
+            if (edit.kind == List::INSERT_EDIT && int(edit.pos) == pos)
+                result.push_back(edit.value);
+        }
+        if (pos < size && !deleted[pos])
+            result.push_back(model[pos]);
+    }
+    model = result;
+    return true;
+}
+
+/***** testBatches *****/
+void testBatches(mt19937 &generator, AllocationPolicy policy)
+{
+    auto list = make_unique<List>();
+    list->setAllocationPolicy(policy);
+    vector<int> model;
+    map<int, NodeHandle> handles; // handles of the elements inserted by insertLast
+    int nextValue = 0;            // every element is distinct
+    for (int round = 0; round < 3000; round++)
+    {
+        if (model.size() < CAPACITY && generator() % 3 == 0)
+        {
+            handles[nextValue] = list->insertLast(nextValue);
+            model.push_back(nextValue++);
+        }
+        int size = int(model.size());
+        vector<Edit> edits;
+        int count = int(generator() % 12);
+        for (int k = 0; k < count; k++)
+        {
+            Edit edit = {List::INSERT_EDIT, 0, 0};
+            if (size > 0 && generator() % 2 == 0)
+            {
+                edit.kind = List::DELETE_EDIT;
+                edit.pos = generator() % size; // sometimes twice the same: rejected
+            }
+            else
+            {
+                edit.pos = generator() % (size + 1); // size: at the tail
+                edit.value = nextValue++;
+            }
+            if (generator() % 40 == 0)
+                edit.pos = size + 1; // out of range: rejected
+            edits.push_back(edit);
+        }
+        if (generator() % 10 == 0)
+        {
+            // Enough insertions to overflow the pool, unless they are deleted too
+            for (int k = 0; k < CAPACITY - size + 1; k++)
+                edits.push_back({List::INSERT_EDIT, unsigned(generator() % (size + 1)), nextValue++});
+        }
+
+        vector<int> expected = model;
+        bool valid = applyToModel(expected, edits);
+        bool applied = list->applyBatch(edits);
+        assert(applied == valid);
+        if (!applied)
+        {
+            checkList(*list, model); // unchanged
+            continue;
+        }
+        // The handles of the deleted elements are stale, the others still valid
+        for (auto entry = handles.begin(); entry != handles.end();)
+        {
+            bool stays = find(expected.begin(), expected.end(), entry->first) != expected.end();
+            assert(list->isValid(entry->second) == stays);
+            entry = stays ? next(entry) : handles.erase(entry);
+        }
+        model = expected;
+        checkList(*list, model);
+    }
+}
+
+/***** testFullPool *****/
+/*------------------------------------------------------
+    A batch that deletes as many elements as it inserts fits in a full
+    pool: the insertions reuse the deleted nodes.
+-------------------------------------------------------*/
+void testFullPool()
+{
+    for (AllocationPolicy policy : {LIFO_POLICY, LOWEST_INDEX_POLICY})
+    {
+        List list;
+        list.setAllocationPolicy(policy);
+        vector<int> model;
+        for (int i = 0; i < CAPACITY; i++)
+        {
+            list.insertLast(i);
+            model.push_back(i);
+        }
+        vector<Edit> edits = {{List::DELETE_EDIT, 5, 0}, {List::INSERT_EDIT, 5, 100},
+                              {List::DELETE_EDIT, 0, 0}, {List::INSERT_EDIT, unsigned(CAPACITY), 101}};
+        bool applied = list.applyBatch(edits);
+        bool valid = applyToModel(model, edits);
+        assert(applied && valid);
+        checkList(list, model);
+
+        edits.push_back({List::INSERT_EDIT, 0, 102}); // one insertion too many
+        applied = list.applyBatch(edits);
+        assert(!applied);
+        checkList(list, model);
+    }
+}
+
+/***** testRemove *****/
+void testRemove(mt19937 &generator)
+{
+    for (AllocationPolicy policy : {LIFO_POLICY, LOWEST_INDEX_POLICY})
+    {
+        List list;
+        list.setAllocationPolicy(policy);
+        vector<int> model;
+        for (int round = 0; round < 500; round++)
+        {
+            while (int(model.size()) < CAPACITY)
+            {
+                int value = int(generator() % 10); // many duplicates
+                list.insertLast(value);
+                model.push_back(value);
+            }
+            int removed = 0;
+            if (round % 2 == 0)
+            {
+                int divisor = 2 + int(generator() % 3);
+                removed = list.removeIf([divisor](int value)
+                                        { return value % divisor == 0; });
+                size_t before = model.size();
+                model.erase(remove_if(model.begin(), model.end(), [divisor](int value)
+                                      { return value % divisor == 0; }),
+                            model.end());
+                assert(removed == int(before - model.size()));
+            }
+            else
+            {
+                int value = int(generator() % 10);
+                removed = list.removeAll(value);
+                assert(removed == int(count(model.begin(), model.end(), value)));
+                model.erase(remove(model.begin(), model.end(), value), model.end());
+            }
+            assert(contents(list) == model && list.getsize() == int(model.size()));
+        }
+    }
+}
+
+int main()
+{
+    cout.setstate(ios::failbit); // the list reports every operation
+    mt19937 generator(13);
+    testBatches(generator, LIFO_POLICY);
+    testBatches(generator, LOWEST_INDEX_POLICY);
+    testFullPool();
+    testRemove(generator);
+    cout.clear();
+    cout << "Batch tests passed" << endl;
+    return 0;
+}
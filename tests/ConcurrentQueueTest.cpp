@@ -0,0 +1,166 @@
+/**--ConcurrentQueueTest.cpp-----------------------------------------------------------------
+    Tests of ConcurrentQueue: FIFO order, capacity (backpressure), batches, elements larger
+    than a word, and several producers and consumers, one by one and in batches, moving many
+    elements without losing or duplicating any.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -pthread -I. tests/ConcurrentQueueTest.cpp -o queue_test && ./queue_test
+    Add -fsanitize=thread to check the atomics with ThreadSanitizer: it must report nothing.
+-------------------------------------------------------------------------------------------*/
+#include "ConcurrentQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/***** testSingleThread *****/
+void testSingleThread()
+{
+    static ConcurrentQueue<long, 4> queue;
+    long value = 0;
+    assert(queue.isEmpty() && queue.capacity() == 4);
+    [[maybe_unused]] bool done = queue.tryDequeue(value);
+    assert(!done);
+    for (long i = 1; i <= 4; i++)
+    {
+        done = queue.tryEnqueue(i);
+        assert(done);
+    }
+    done = queue.tryEnqueue(5);
+    assert(!done); // full
+    done = queue.tryDequeue(value);
+    assert(done && value == 1);
+    done = queue.tryEnqueue(5);
+    assert(done); // the freed node is reused
+    for (long i = 2; i <= 5; i++)
+    {
+        done = queue.tryDequeue(value);
+        assert(done && value == i);
+    }
+    assert(queue.isEmpty());
+}
+
+/***** testBatches *****/
+void testBatches()
+{
+    static ConcurrentQueue<long, 3> queue;
+    long items[5] = {1, 2, 3, 4, 5}, results[5] = {};
+    [[maybe_unused]] size_t moved = queue.enqueueBatch(items, 5);
+    assert(moved == 3); // only as many as fit
+    [[maybe_unused]] bool done = queue.tryEnqueue(9);
+    assert(!done);
+    moved = queue.dequeueBatch(results, 2);
+    assert(moved == 2 && results[0] == 1 && results[1] == 2);
+    moved = queue.enqueueBatch(items + 3, 2); // the two freed nodes are reused
+    assert(moved == 2);
+    moved = queue.dequeueBatch(results, 5);
+    assert(moved == 3 && results[0] == 3 && results[1] == 4 && results[2] == 5);
+    moved = queue.dequeueBatch(results, 5);
+    assert(queue.isEmpty() && moved == 0);
+}
+
+/***** testLargeElements *****/
+/*------------------------------------------------------
+    Elements of several words, and of a size that is not a multiple of
+    a word, come out unchanged.
+-------------------------------------------------------*/
+void testLargeElements()
+{
+    struct Record
+    {
+        long id;
+        double values[3];
+        char tag[5];
+    };
+    static ConcurrentQueue<Record, 8> queue;
+    for (long i = 0; i < 8; i++)
+    {
+        Record record = {i, {i * 0.5, i * 1.5, i * 2.5}, "abcd"};
+        [[maybe_unused]] bool done = queue.tryEnqueue(record);
+        assert(done);
+    }
+    Record results[8];
+    [[maybe_unused]] size_t moved = queue.dequeueBatch(results, 8);
+    assert(moved == 8);
+    for (long i = 0; i < 8; i++)
+    {
+        assert(results[i].id == i && results[i].values[2] == i * 2.5);
+        assert(string(results[i].tag) == "abcd");
+    }
+}
+
+/***** testManyThreads *****/
+/*------------------------------------------------------
+    Producers enqueue disjoint ranges of numbers; consumers check that the
+    numbers of each producer come out in order, and the sum checks that
+    every number came out exactly once. With batch > 1, both sides move
+    up to batch elements at a time.
+-------------------------------------------------------*/
+void testManyThreads(int producers, int consumers, long perProducer, size_t batch)
+{
+    static ConcurrentQueue<long, 256> queue; // small, so producers hit backpressure
+    atomic<long> sum(0), received(0);
+    long total = producers * perProducer;
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&, p]
+                             {
+                                 vector<long> items(batch);
+                                 for (long i = 0; i < perProducer;)
+                                 {
+                                     size_t count = min(batch, size_t(perProducer - i));
+                                     for (size_t k = 0; k < count; k++)
+                                         items[k] = p * perProducer + i + long(k);
+                                     size_t moved = queue.enqueueBatch(items.data(), count);
+                                     if (moved == 0)
+                                         this_thread::yield();
+                                     i += long(moved);
+                                 } });
+    }
+    for (int c = 0; c < consumers; c++)
+    {
+        threads.emplace_back([&]
+                             {
+                                 vector<long> lastSeen(producers, -1), values(batch);
+                                 while (received.load() < total)
+                                 {
+                                     size_t moved = (batch == 1) ? (queue.tryDequeue(values[0]) ? 1 : 0)
+                                                                 : queue.dequeueBatch(values.data(), batch);
+                                     if (moved == 0)
+                                     {
+                                         this_thread::yield();
+                                         continue;
+                                     }
+                                     for (size_t k = 0; k < moved; k++)
+                                     {
+                                         long producer = values[k] / perProducer;
+                                         assert(values[k] > lastSeen[producer]); // FIFO per producer
+                                         lastSeen[producer] = values[k];
+                                         sum += values[k];
+                                     }
+                                     received += long(moved);
+                                 } });
+    }
+    for (thread &t : threads)
+        t.join();
+    assert(received.load() == total && sum.load() == total * (total - 1) / 2);
+    assert(queue.isEmpty());
+}
+
+int main()
+{
+    testSingleThread();
+    testBatches();
+    testLargeElements();
+    testManyThreads(1, 1, 200000, 1);
+    testManyThreads(4, 4, 100000, 1);
+    testManyThreads(4, 4, 100000, 16);
+    cout << "ConcurrentQueue tests passed" << endl;
+    return 0;
+}
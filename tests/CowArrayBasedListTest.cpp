@@ -0,0 +1,142 @@
+/**--CowArrayBasedListTest.cpp--------------------------------------------------------------
+    Tests of CowArrayBasedList: copies and assignments share one list until the first write,
+    which gives the writer its own copy and leaves the others unchanged; an unshared list is
+    modified in place; search never reorders the list, even when the wrapped list has a
+    reordering policy. Snapshots are also read by other threads while the original is
+    modified, which is clean under ThreadSanitizer:
+        g++ -std=c++20 -O1 -g -fsanitize=thread -I. tests/CowArrayBasedListTest.cpp -o cow_test
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/CowArrayBasedListTest.cpp -o cow_test && ./cow_test
+-------------------------------------------------------------------------------------------*/
+#include "CowArrayBasedList.h"
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+typedef CowArrayBasedList<string, 16> CowList;
+
+/***** contents *****/
+vector<string> contents(const CowList &list)
+{
+    vector<string> items;
+    list.view().forEachReverse([&](const string &item)
+                               { items.insert(items.begin(), item); });
+    return items;
+}
+
+/***** testSharing *****/
+void testSharing()
+{
+    CowList original;
+    original.insertLast("a");
+    original.insertLast("b");
+    assert(!original.isShared());
+    const auto *before = &original.view();
+    original.insertLast("c"); // not shared: modified in place
+    assert(&original.view() == before);
+
+    CowList copy = original;
+    CowList assigned;
+    assigned.insertLast("z");
+    assigned = original;
+    assert(original.isShared() && copy.isShared() && assigned.isShared());
+    assert(&copy.view() == &original.view() && &assigned.view() == &original.view());
+
+    copy.insertFirst("x"); // the first write detaches the copy only
+    assert(&copy.view() != &original.view() && !copy.isShared());
+    assert((contents(copy) == vector<string>{"x", "a", "b", "c"}));
+    assert((contents(original) == vector<string>{"a", "b", "c"}) && original.isShared());
+
+    assigned.deleteLast();
+    assert(!original.isShared() && !assigned.isShared());
+    assert((contents(assigned) == vector<string>{"a", "b"}));
+    assert((contents(original) == vector<string>{"a", "b", "c"}));
+
+    assigned = assigned; // self-assignment keeps the list
+    assert((contents(assigned) == vector<string>{"a", "b"}) && !assigned.isShared());
+
+    {
+        CowList scoped = original;
+        assert(original.isShared());
+    }
+    assert(!original.isShared()); // the last copy went away
+}
+
+/***** testNoReorder *****/
+/*------------------------------------------------------
+    The wrapped list moves found nodes to the front, but a search
+    through the wrapper never does, shared or not.
+-------------------------------------------------------*/
+void testNoReorder()
+{
+    CowList::ListType moving;
+    moving.setReorderPolicy(MOVE_TO_FRONT);
+    moving.insertLast("a");
+    moving.insertLast("b");
+    moving.insertLast("c");
+
+    CowList original(moving);
+    CowList snapshot = original;
+    for (int round = 0; round < 3; round++)
+    {
+        assert(snapshot.search("c") == 2 && original.search("b") == 1);
+        assert(snapshot.isShared() && &snapshot.view() == &original.view());
+    }
+    assert((contents(original) == vector<string>{"a", "b", "c"}));
+
+    snapshot.insertLast("d"); // the detached copy keeps the policy, and search still does not reorder
+    assert(snapshot.view().getReorderPolicy() == MOVE_TO_FRONT);
+    assert(snapshot.search("d") == 3 && snapshot.search("d") == 3);
+}
+
+/***** testThreads *****/
+/*------------------------------------------------------
+    Every thread reads a snapshot of the list, writes to a copy of its
+    own, then drops both; meanwhile the main thread writes to the
+    original, which it modifies in place once it is no longer shared.
+-------------------------------------------------------*/
+void testThreads()
+{
+    CowList original;
+    for (int i = 0; i < 10; i++)
+        original.insertLast(to_string(i));
+    for (int round = 0; round < 200; round++)
+    {
+        vector<thread> readers;
+        for (int t = 0; t < 3; t++)
+        {
+            CowList snapshot = original; // copied by this thread, used by the reader
+            readers.emplace_back([snapshot, t]() mutable
+                                 {
+                int found = snapshot.search("9");
+                assert(found == snapshot.getsize() - 1);
+                CowList own = snapshot;
+                own.insertFirst("reader " + to_string(t));
+                assert(own.getsize() == snapshot.getsize() + 1 && own.search("9") == found + 1); });
+        }
+        // Once the readers are gone (the count drops to one) the writes go in place
+        while (original.isShared())
+            this_thread::yield();
+        const auto *before = &original.view();
+        original.deleteFirst();
+        original.insertFirst("round " + to_string(round));
+        assert(&original.view() == before && original.search("9") == 9);
+        for (thread &reader : readers)
+            reader.join();
+    }
+}
+
+int main()
+{
+    cout.setstate(ios::failbit); // the list reports every operation
+    testSharing();
+    testNoReorder();
+    testThreads();
+    cout.clear();
+    cout << "CowArrayBasedList tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,171 @@
+/**--HandleTest.cpp-------------------------------------------------------------------------
+    Tests of the handle operations of ArrayBasedList (isValid, erase, update and insertAfter
+    with a handle): random operations are applied both to a list and to a vector model, and
+    stale handles must be rejected without changing the list. Copies and assignments, of
+    trivially copyable elements or not, must never leave a handle valid in the other list.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/HandleTest.cpp -o handle_test && ./handle_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <cassert>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/***** contents *****/
+template <typename ElementType, int Capacity>
+vector<ElementType> contents(const ArrayBasedList<ElementType, Capacity> &list)
+{
+    vector<ElementType> items;
+    list.forEachReverse([&](const ElementType &item)
+                        { items.insert(items.begin(), item); });
+    return items;
+}
+
+/***** testAgainstModel *****/
+/*------------------------------------------------------
+    The model keeps, for every element, the handle returned when it was
+    inserted; the handles of the deleted elements must all be stale.
+-------------------------------------------------------*/
+template <typename ElementType>
+void testAgainstModel(mt19937 &generator, ElementType (*makeValue)(int))
+{
+    typedef ArrayBasedList<ElementType, 64> List;
+    auto list = make_unique<List>();
+    vector<ElementType> model;
+    vector<NodeHandle> handles; // handles[i]: handle of model[i]
+    vector<NodeHandle> stale;   // handles of deleted elements
+    for (int step = 0; step < 20000; step++)
+    {
+        int operation = generator() % 8;
+        int size = int(model.size());
+        ElementType value = makeValue(int(generator() % 1000));
+        if (operation < 2 && size < 64)
+        {
+            NodeHandle handle = list->insertLast(value);
+            model.push_back(value);
+            handles.push_back(handle);
+        }
+        else if (operation == 2 && size > 0 && size < 64)
+        {
+            int pos = int(generator() % size);
+            NodeHandle handle = list->insertAfter(value, handles[pos]);
+            assert(list->isValid(handle));
+            model.insert(model.begin() + pos + 1, value);
+            handles.insert(handles.begin() + pos + 1, handle);
+        }
+        else if (operation == 3 && size > 0)
+        {
+            int pos = int(generator() % size);
+            bool erased = list->erase(handles[pos]);
+            assert(erased);
+            stale.push_back(handles[pos]);
+            model.erase(model.begin() + pos);
+            handles.erase(handles.begin() + pos);
+        }
+        else if (operation == 4 && size > 0)
+        {
+            int pos = int(generator() % size);
+            bool updated = list->update(handles[pos], value);
+            assert(updated && list->isValid(handles[pos]));
+            model[pos] = value;
+        }
+        else if (operation == 5 && size > 0)
+        {
+            int pos = int(generator() % size); // deleted by position: its handle goes stale
+            list->deleteAtPos(pos);
+            stale.push_back(handles[pos]);
+            model.erase(model.begin() + pos);
+            handles.erase(handles.begin() + pos);
+        }
+        else if (operation == 6 && !stale.empty())
+        {
+            // A stale handle is rejected, and nothing changes
+            NodeHandle handle = stale[generator() % stale.size()];
+            bool erased = list->erase(handle);
+            bool updated = list->update(handle, value);
+            NodeHandle inserted = list->insertAfter(value, handle);
+            assert(!erased && !updated && inserted == NULL_HANDLE);
+        }
+        else if (operation == 7 && generator() % 50 == 0)
+        {
+            list->clear(); // every handle goes stale
+            stale.insert(stale.end(), handles.begin(), handles.end());
+            model.clear();
+            handles.clear();
+        }
+        assert(list->getsize() == int(model.size()) && contents(*list) == model);
+        for (NodeHandle handle : handles)
+            assert(list->isValid(handle));
+        for (size_t k = stale.size() > 20 ? stale.size() - 20 : 0; k < stale.size(); k++)
+            assert(!list->isValid(stale[k]));
+    }
+}
+
+/***** testCopies *****/
+/*------------------------------------------------------
+    No handle crosses a copy or an assignment, whether the pool is cloned
+    in one block (trivially copyable elements) or copied node by node.
+    The source is built with holes and reused nodes, so its generations
+    are not all 1.
+-------------------------------------------------------*/
+template <typename ElementType>
+void testCopies(ElementType (*makeValue)(int))
+{
+    typedef ArrayBasedList<ElementType, 32> List;
+    for (AllocationPolicy policy : {LIFO_POLICY, LOWEST_INDEX_POLICY})
+    {
+        List source;
+        source.setAllocationPolicy(policy);
+        vector<NodeHandle> handles;
+        for (int i = 0; i < 10; i++)
+            handles.push_back(source.insertLast(makeValue(i)));
+        source.erase(handles[3]);
+        source.erase(handles[7]);
+        handles[3] = source.insertFirst(makeValue(100)); // reuses a freed node
+        handles[7] = source.insertLast(makeValue(101));
+
+        List copy(source);
+        assert(contents(copy) == contents(source));
+        for (NodeHandle handle : handles)
+            assert(source.isValid(handle) && !copy.isValid(handle));
+
+        // Assignment: the old handles of the target are stale, and the
+        // handles of the source are not valid in it (the scenario of a = b)
+        List target;
+        vector<NodeHandle> old;
+        for (int i = 0; i < 5; i++)
+            old.push_back(target.insertLast(makeValue(i)));
+        target = source;
+        assert(contents(target) == contents(source));
+        for (NodeHandle handle : old)
+            assert(!target.isValid(handle));
+        for (NodeHandle handle : handles)
+            assert(source.isValid(handle) && !target.isValid(handle));
+
+        // The copies have handles of their own
+        NodeHandle added = target.insertLast(makeValue(200));
+        bool updated = target.update(added, makeValue(201));
+        assert(updated && target.isValid(added));
+    }
+}
+
+int intValue(int i) { return i; }
+string stringValue(int i) { return "value number " + to_string(i); }
+
+int main()
+{
+    cout.setstate(ios::failbit); // the list reports every operation
+    mt19937 generator(11);
+    testAgainstModel<int>(generator, intValue);
+    testAgainstModel<string>(generator, stringValue);
+    testCopies<int>(intValue);
+    testCopies<string>(stringValue);
+    cout.clear();
+    cout << "Handle tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**--InlineStringTest.cpp-------------------------------------------------------------------
+    Tests of InlineString: texts are only converted explicitly, a text longer than Capacity
+    is never stored (not even in part), and a key longer than Capacity never matches an
+    element of a list of ShortString with transparent keys, whatever its first characters.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/InlineStringTest.cpp -o inline_string_test && ./inline_string_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include "InlineString.h"
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Transparent keys: a text is compared with the elements without being converted
+template <int Capacity>
+using ShortStringList = ArrayBasedList<ShortString, Capacity, 0, equal_to<>>;
+
+const string ALPHABET = "abcdefghijklmnopqrstuvwxyz"; // exactly the 26 characters of a ShortString
+
+// No implicit conversion from a text, but an explicit one
+static_assert(!is_convertible_v<string, ShortString> && !is_convertible_v<const char *, ShortString>);
+static_assert(is_constructible_v<ShortString, string> && is_constructible_v<ShortString, string_view>);
+static_assert(is_trivially_copyable_v<ShortString> && sizeof(ShortString) == 32);
+
+/***** buildAtCompileTime *****/
+constexpr int buildAtCompileTime()
+{
+    ShortStringList<5> list;
+    list.insertLast(ShortString("abc"));
+    list.insertLast(ShortString("de"));
+    return list.search("de");
+}
+static_assert(buildAtCompileTime() == 1);
+
+/***** testCreation *****/
+void testCreation()
+{
+    ShortString text;
+    bool created = ShortString::tryCreate(ALPHABET, text);
+    assert(created && text == ALPHABET && text.length() == 26);
+    created = ShortString::tryCreate(ALPHABET + "-long", text);
+    assert(!created && text == ALPHABET); // unchanged
+
+    // The constructor stores nothing of a text too long, and says so
+    ostringstream messages;
+    streambuf *console = cout.rdbuf(messages.rdbuf());
+    ShortString tooLong(ALPHABET + "-long");
+    cout.rdbuf(console);
+    assert(tooLong.length() == 0 && messages.str().find("not stored") != string::npos);
+
+    // >> fails on a word that does not fit
+    istringstream input("short " + ALPHABET + "-long");
+    ShortString word;
+    input >> word;
+    assert(input && word == "short");
+    input >> word;
+    assert(input.fail() && word == "short");
+}
+
+/***** testLongKeys *****/
+/*------------------------------------------------------
+    A key longer than Capacity is compared as it is: it never matches
+    the element made of its first 26 characters.
+-------------------------------------------------------*/
+void testLongKeys()
+{
+    ShortStringList<10> list;
+    list.insertLast(ShortString(ALPHABET));
+    list.insertLast(ShortString("other"));
+    string longKey = ALPHABET + "-something-else";
+
+    assert(list.search(longKey) == -1);
+    assert(list.search(longKey.c_str()) == -1);
+    assert(list.search(string_view(longKey)) == -1);
+    assert(list.search(ALPHABET) == 0);
+    ShortString element(ALPHABET);
+    assert(element != longKey && longKey != element && element == ALPHABET);
+
+    list.deleteElement(longKey);
+    assert(list.getsize() == 2);
+    int removed = list.removeAll(longKey);
+    assert(removed == 0 && list.getsize() == 2);
+
+    vector<string> keys(20, "missing"); // enough keys for the hashed search too
+    keys[3] = ALPHABET;
+    keys[4] = longKey;
+    keys[5] = "other";
+    vector<int> positions = list.searchMany(keys);
+    assert(positions[3] == 0 && positions[4] == -1 && positions[5] == 1);
+}
+
+int main()
+{
+    testCreation();
+    cout.setstate(ios::failbit); // the list reports every operation
+    testLongKeys();
+    cout.clear();
+    cout << "InlineString tests passed" << endl;
+    return 0;
+}
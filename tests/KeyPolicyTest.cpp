@@ -0,0 +1,131 @@
+/**--KeyPolicyTest.cpp----------------------------------------------------------------------
+    Tests of the key policies of ArrayBasedList: by default a key of another type is
+    converted to ElementType (ArrayBasedList<int>::search(3.5) finds 3), while a list with
+    a transparent KeyEqual (equal_to<>) compares the key as it is, so that searching a list
+    of strings for a text allocates nothing (operator new is replaced to count the calls).
+    Custom policies (StringPolicies.h) are used by search, searchMany and removeAll.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/KeyPolicyTest.cpp -o key_policy_test && ./key_policy_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include "CowArrayBasedList.h"
+#include "StringPolicies.h"
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+long allocations = 0; // calls to operator new while counting is set
+bool counting = false;
+
+void *operator new(size_t size)
+{
+    if (counting)
+        allocations++;
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+        throw bad_alloc();
+    return memory;
+}
+
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+
+/***** testDefaultConversion *****/
+/*------------------------------------------------------
+    equal_to<ElementType> is the default: the key is converted first,
+    as it would be by any function taking an ElementType.
+-------------------------------------------------------*/
+void testDefaultConversion()
+{
+    ArrayBasedList<int, 10> list;
+    list.insertLast(1);
+    list.insertLast(3);
+    list.insertLast(5);
+    assert(list.search(3.5) == 1 && list.search(3) == 1 && list.search(5L) == 2);
+    list.deleteElement(5.9); // deletes 5
+    assert(list.getsize() == 2 && list.search(5) == -1);
+
+    CowArrayBasedList<int, 10> shared(list);
+    assert(shared.search(3.5) == 1);
+
+    // Opting in to transparent keys compares 3.5 itself
+    ArrayBasedList<int, 10, 0, equal_to<>> transparent;
+    transparent.insertLast(3);
+    assert(transparent.search(3.5) == -1 && transparent.search(3) == 0);
+}
+
+/***** testNoAllocation *****/
+void testNoAllocation()
+{
+    const string PREFIX = "a string too long for the small string buffer, number ";
+    ArrayBasedList<string, 50, 0, equal_to<>> list;
+    ArrayBasedList<string, 50> converting;
+    for (int i = 0; i < 20; i++)
+    {
+        list.insertLast(PREFIX + to_string(i));
+        converting.insertLast(PREFIX + to_string(i));
+    }
+    string key = PREFIX + "7";
+    string missing = PREFIX + "99";
+
+    counting = true;
+    int found = list.search(key.c_str());
+    int viewed = list.search(string_view(key));
+    int absent = list.search(missing.c_str());
+    list.deleteElement(missing.c_str());
+    int removed = list.removeAll(missing.c_str());
+    counting = false;
+    assert(found == 7 && viewed == 7 && absent == -1 && removed == 0);
+    assert(allocations == 0);
+
+    // Without opting in, the text is converted to a string first
+    counting = true;
+    found = converting.search(key.c_str());
+    counting = false;
+    assert(found == 7 && allocations > 0);
+}
+
+/***** testCustomPolicies *****/
+void testCustomPolicies()
+{
+    ArrayBasedList<string, 20, 0, CaseInsensitiveEqual, CaseInsensitiveHash> names;
+    names.insertLast("Alice");
+    names.insertLast("BOB");
+    names.insertLast("bob");
+    assert(names.search("bob") == 1 && names.search(ShortString("ALICE")) == 0);
+    vector<const char *> keys;
+    for (int i = 0; i < 20; i++)
+        keys.push_back(i % 3 == 0 ? "carol" : "BoB");
+    vector<int> positions = names.searchMany(keys);
+    for (int i = 0; i < 20; i++)
+        assert(positions[i] == (i % 3 == 0 ? -1 : 1));
+    int removed = names.removeAll("BOB");
+    assert(removed == 2 && names.getsize() == 1);
+
+    ArrayBasedList<ShortString, 20, 0, PrefixEqual> words;
+    words.insertLast(ShortString("apple"));
+    words.insertLast(ShortString("banana"));
+    words.insertLast(ShortString("band"));
+    assert(words.search("ban") == 1);
+    vector<string> prefixes(12, "app"); // no hash: compared directly
+    assert(words.searchMany(prefixes)[11] == 0);
+    removed = words.removeAll("ban");
+    assert(removed == 2 && words.getsize() == 1);
+}
+
+int main()
+{
+    cout.setstate(ios::failbit); // the list reports every operation
+    testDefaultConversion();
+    testNoAllocation();
+    testCustomPolicies();
+    cout.clear();
+    cout << "KeyPolicy tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**--LruCacheTest.cpp-----------------------------------------------------------------------
+    Tests of LruCache: 2M random get, put and erase calls are applied both to a cache and
+    to a reference LRU cache made of a std::list and a std::unordered_map, and they must
+    always agree on the hits, the values, the evictions and the statistics. The same is
+    done with a hash that puts many keys on the same slots, around the end of the table,
+    so that erasing keys exercises the backward shift deletion of the table.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/LruCacheTest.cpp -o lru_cache_test && ./lru_cache_test
+-------------------------------------------------------------------------------------------*/
+#include "LruCache.h"
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+/**--CollidingHash--------------------------------------------------
+ Sends every group of 8 keys to the same home slot, with the homes
+ just before the end of a 128-slot table, so the probe sequences are
+ long and wrap around.
+ ---------------------------------------------------------------**/
+struct CollidingHash
+{
+    size_t operator()(int key) const
+    {
+        return size_t(120 + key / 8);
+    }
+};
+
+/**--ReferenceCache--------------------------------------------------
+ A straightforward LRU cache: the list holds the entries from the
+ most to the least recently used, and the map finds them.
+ ---------------------------------------------------------------**/
+class ReferenceCache
+{
+public:
+    int capacity;
+    list<pair<int, int>> entries;
+    unordered_map<int, list<pair<int, int>>::iterator> index;
+    unsigned long hits = 0, misses = 0, evictions = 0;
+
+    explicit ReferenceCache(int capacity) : capacity(capacity) {}
+
+    int *get(int key)
+    {
+        auto found = index.find(key);
+        if (found == index.end())
+        {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        entries.splice(entries.begin(), entries, found->second);
+        return &found->second->second;
+    }
+
+    void put(int key, int value)
+    {
+        auto found = index.find(key);
+        if (found != index.end())
+        {
+            found->second->second = value;
+            entries.splice(entries.begin(), entries, found->second);
+            return;
+        }
+        if (int(entries.size()) == capacity)
+        {
+            index.erase(entries.back().first);
+            entries.pop_back();
+            evictions++;
+        }
+        entries.push_front({key, value});
+        index[key] = entries.begin();
+    }
+
+    bool erase(int key)
+    {
+        auto found = index.find(key);
+        if (found == index.end())
+            return false;
+        entries.erase(found->second);
+        index.erase(found);
+        return true;
+    }
+};
+
+/***** testAgainstReference *****/
+template <int Capacity, typename Hash>
+void testAgainstReference(mt19937 &generator, int keys, long operations)
+{
+    LruCache<int, int, Capacity, Hash> cache;
+    ReferenceCache reference(Capacity);
+    for (long step = 0; step < operations; step++)
+    {
+        int key = int(generator() % keys);
+        int operation = int(generator() % 10);
+        if (operation < 5)
+        {
+            int *value = cache.get(key);
+            int *expected = reference.get(key);
+            assert((value != nullptr) == (expected != nullptr));
+            assert(value == nullptr || *value == *expected);
+        }
+        else if (operation < 9)
+        {
+            cache.put(key, int(step));
+            reference.put(key, int(step));
+        }
+        else
+        {
+            bool erased = cache.erase(key);
+            bool expected = reference.erase(key);
+            assert(erased == expected);
+        }
+        assert(cache.getsize() == int(reference.entries.size()));
+        assert(cache.getHits() == reference.hits && cache.getMisses() == reference.misses);
+        assert(cache.getEvictions() == reference.evictions);
+        if (step % 64 == 0)
+        {
+            // every cached key is still reachable in the table, and no other one
+            for (int k = 0; k < keys; k++)
+                assert(cache.contains(k) == (reference.index.count(k) == 1));
+        }
+    }
+}
+
+/***** testStatistics *****/
+void testStatistics()
+{
+    LruCache<string, int, 2> cache;
+    assert(cache.hitRate() == 0.0 && cache.isEmpty() && cache.capacity() == 2);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    int value = 0;
+    bool hit = cache.get("a", value); // "b" is now the least recently used
+    assert(hit && value == 1);
+    cache.put("c", 3); // evicts "b"
+    assert(cache.contains("a") && !cache.contains("b") && cache.contains("c"));
+    hit = cache.get("b", value);
+    assert(!hit && value == 1);
+    assert(cache.getHits() == 1 && cache.getMisses() == 1 && cache.getEvictions() == 1);
+    assert(cache.hitRate() == 0.5);
+    cache.resetStats();
+    assert(cache.getHits() == 0 && cache.getMisses() == 0 && cache.getEvictions() == 0);
+    assert(cache.getsize() == 2);
+}
+
+int main()
+{
+    mt19937 generator(1);
+    testAgainstReference<37, hash<int>>(generator, 100, 2000000);
+    testAgainstReference<50, CollidingHash>(generator, 80, 300000); // 128 slots
+    testStatistics();
+    cout << "LruCache tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**--MemoryResourceTest.cpp-----------------------------------------------------------------
+    Tests of storage pools with a memory resource: allocator-aware elements allocate from
+    the resource of their pool, when they are inserted, when a list is assigned over it,
+    and when a pool with nodes never built yet is assigned over, while copies of a pool
+    or a list use the global heap.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/MemoryResourceTest.cpp -o memory_resource_test && ./memory_resource_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <cassert>
+#include <memory_resource>
+#include <string>
+
+using namespace std;
+
+const pmr::string LONG_TEXT(100, 'x'); // too long for the small string buffer: allocates
+
+/**--CountingResource----------------------------------------------
+ Counts the bytes allocated through it, and takes them from the heap.
+ ---------------------------------------------------------------**/
+class CountingResource : public pmr::memory_resource
+{
+public:
+    size_t allocated = 0;
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocated += bytes;
+        return pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override
+    {
+        pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/***** testPoolAssignment *****/
+/*------------------------------------------------------
+    The target pool never built the nodes it receives: they must still be
+    built with its resource before the elements are copied in.
+-------------------------------------------------------*/
+void testPoolAssignment()
+{
+    typedef NodePool<pmr::string, 100> Pool;
+    CountingResource resource;
+    Pool source, target(&resource);
+    for (int i = 0; i < 10; i++)
+        source.getNode(source.newNode()).data = LONG_TEXT;
+    target.getNode(target.newNode()).data = LONG_TEXT; // one node built before the assignment
+    target = source;
+    for (int i = 0; i < 10; i++)
+    {
+        assert(target.getNode(i).data == LONG_TEXT);
+        assert(target.getNode(i).data.get_allocator().resource() == &resource);
+    }
+    assert(resource.allocated >= 10 * LONG_TEXT.size());
+
+    Pool copy(target); // a copy uses the global heap
+    assert(copy.getNode(0).data.get_allocator().resource() == pmr::get_default_resource());
+}
+
+/***** testListAssignment *****/
+void testListAssignment()
+{
+    typedef ArrayBasedList<pmr::string, 100> List;
+    CountingResource resource;
+    List source, target(&resource);
+    for (int i = 0; i < 10; i++)
+        source.insertLast(LONG_TEXT);
+    assert(resource.allocated == 0);
+    target = source;
+    assert(target.getResource() == &resource);
+    assert(target.getsize() == 10 && target.search(LONG_TEXT) == 0);
+    assert(resource.allocated >= 10 * LONG_TEXT.size());
+
+    size_t before = resource.allocated;
+    List copy(target); // a copy uses the global heap
+    assert(resource.allocated == before && copy.getsize() == 10);
+}
+
+int main()
+{
+    cout.setstate(ios::failbit); // the list reports every operation
+    testPoolAssignment();
+    testListAssignment();
+    cout.clear();
+    cout << "MemoryResource tests passed" << endl;
+    return 0;
+}
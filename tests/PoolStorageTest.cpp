@@ -0,0 +1,91 @@
+/**--PoolStorageTest.cpp--------------------------------------------------------------------
+    Tests of large, aligned pools: node alignment and stride, pool objects built by
+    createPoolObject with every kind of pages, and traversals of a large list in both
+    directions.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/PoolStorageTest.cpp -o pool_storage_test && ./pool_storage_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include "PoolStorage.h"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+/***** testAlignment *****/
+void testAlignment()
+{
+    static_assert(nodeStride<int>() == 16); // int + next + prev, rounded to a power of two
+    static_assert(sizeof(NodePool<int, 4, CACHE_LINE_SIZE>) >= 4 * CACHE_LINE_SIZE);
+
+    static NodePool<int, 100, CACHE_LINE_SIZE> pool;
+    NodePtr a = pool.newNode(), b = pool.newNode();
+    uintptr_t first = reinterpret_cast<uintptr_t>(&pool.getNode(a));
+    uintptr_t second = reinterpret_cast<uintptr_t>(&pool.getNode(b));
+    assert(first % CACHE_LINE_SIZE == 0 && second - first == CACHE_LINE_SIZE);
+}
+
+/***** testPoolObjects *****/
+/*------------------------------------------------------
+    Every kind of pages gives a usable list (explicit huge pages fall back
+    to transparent ones when none are reserved).
+-------------------------------------------------------*/
+void testPoolObjects()
+{
+    typedef ArrayBasedList<int, 100000, 16> List;
+    PageMode modes[] = {NORMAL_PAGES, TRANSPARENT_HUGE_PAGES, EXPLICIT_HUGE_PAGES};
+    for (PageMode mode : modes)
+    {
+        List *list = createPoolObject<List>(StorageOptions{mode, -1});
+        assert(list != nullptr);
+        assert(reinterpret_cast<uintptr_t>(list) % HUGE_PAGE_SIZE == 0);
+        vector<int> items(50000);
+        for (int i = 0; i < 50000; i++)
+            items[i] = i;
+        cout.setstate(ios::failbit); // appendAll reports the insertion
+        int appended = list->appendAll(items);
+        cout.clear();
+        assert(appended == 50000);
+        assert(list->getsize() == 50000 && list->search(49999) == 49999);
+        destroyPoolObject(list);
+    }
+    destroyPoolObject<List>(nullptr); // allowed, does nothing
+}
+
+/***** testLargeTraversals *****/
+/*------------------------------------------------------
+    Above 4096 nodes, the reverse traversals must still visit every element
+    once, from tail to head, after insertions and deletions everywhere.
+-------------------------------------------------------*/
+void testLargeTraversals()
+{
+    auto list = make_unique<ArrayBasedList<int, 10007, 16>>();
+    cout.setstate(ios::failbit); // the list reports every insertion
+    for (int i = 0; i < 10007; i++)
+        list->insertFirst(i);
+    for (int i = 0; i < 100; i++)
+        list->deleteAtPos(5000);
+    list->reverse();
+    cout.clear();
+
+    vector<int> backward, viewed;
+    for (int x : list->reversed())
+        viewed.push_back(x);
+    list->forEachReverse([&](int x)
+                         { backward.push_back(x); });
+    assert(int(viewed.size()) == list->getsize() && viewed == backward);
+    assert(viewed.front() == 10006 && viewed.back() == 0);
+}
+
+int main()
+{
+    testAlignment();
+    testPoolObjects();
+    testLargeTraversals();
+    cout << "PoolStorage tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,200 @@
+/**--ReorderPolicyTest.cpp------------------------------------------------------------------
+    Tests of the self-organizing lists: random insertions, deletions, searches, copies and
+    insertAfter calls are applied both to an ArrayBasedList and to a simple vector model of
+    each ReorderPolicy, and the two must always hold the same elements in the same order.
+    Also checks that COUNT_ORDER is refused by lists without access counters, that const
+    lists and copy-on-write lists are never reordered, and that the counters cost nothing
+    to the lists that do not use them.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/ReorderPolicyTest.cpp -o reorder_test && ./reorder_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include "CowArrayBasedList.h"
+#include <cassert>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+template <int Capacity>
+using CountingList = ArrayBasedList<int, Capacity, 0, equal_to<>, hash<int>, true>;
+
+/**--Model--------------------------------------------------
+ The expected order of the list, with the access count of
+ every element, reordered as the policy says.
+ ---------------------------------------------------------------**/
+struct Model
+{
+    vector<int> items;
+    vector<unsigned> counts;
+    ReorderPolicy policy;
+
+    int find(int item) const
+    {
+        for (size_t i = 0; i < items.size(); i++)
+            if (items[i] == item)
+                return int(i);
+        return -1;
+    }
+
+    void move(int from, int to)
+    {
+        int item = items[from];
+        unsigned count = counts[from];
+        items.erase(items.begin() + from);
+        counts.erase(counts.begin() + from);
+        items.insert(items.begin() + to, item);
+        counts.insert(counts.begin() + to, count);
+    }
+
+    void insert(int pos, int item)
+    {
+        items.insert(items.begin() + pos, item);
+        counts.insert(counts.begin() + pos, 0);
+    }
+
+    void erase(int pos)
+    {
+        items.erase(items.begin() + pos);
+        counts.erase(counts.begin() + pos);
+    }
+
+    // Applies the policy to the element found at pos; returns its new position
+    int reorder(int pos)
+    {
+        if (policy == MOVE_TO_FRONT)
+        {
+            move(pos, 0);
+            return 0;
+        }
+        if (policy == TRANSPOSE && pos > 0)
+        {
+            move(pos, pos - 1);
+            return pos - 1;
+        }
+        if (policy == COUNT_ORDER)
+        {
+            counts[pos]++;
+            int target = pos - 1;
+            while (target >= 0 && counts[target] < counts[pos])
+                target--;
+            move(pos, target + 1);
+            return target + 1;
+        }
+        return pos;
+    }
+};
+
+/***** contents *****/
+template <typename List>
+vector<int> contents(const List &list)
+{
+    vector<int> items;
+    list.forEachReverse([&](int item)
+                        { items.insert(items.begin(), item); });
+    return items;
+}
+
+/***** testAgainstModel *****/
+template <int Capacity>
+void testAgainstModel(mt19937 &generator, ReorderPolicy policy)
+{
+    auto list = make_unique<CountingList<Capacity>>();
+    list->setReorderPolicy(policy);
+    Model model{{}, {}, policy};
+    for (int step = 0; step < 20000; step++)
+    {
+        int operation = generator() % 8;
+        int value = generator() % 30;
+        int size = int(model.items.size());
+        if (operation == 0 && size < Capacity)
+        {
+            list->insertLast(value);
+            model.insert(size, value);
+        }
+        else if (operation == 1 && size < Capacity)
+        {
+            unsigned pos = generator() % (size + 1);
+            list->insertAtPos(value, pos);
+            model.insert(pos, value);
+        }
+        else if (operation == 2 && size > 0)
+        {
+            unsigned pos = generator() % size;
+            list->deleteAtPos(pos);
+            model.erase(pos);
+        }
+        else if (operation == 3 || operation == 4)
+        {
+            int expected = model.find(value);
+            int found = list->search(value); // the position before the move
+            assert(found == expected);
+            if (expected >= 0)
+                model.reorder(expected);
+            const CountingList<Capacity> &constList = *list; // never reordered
+            assert(constList.search(value) == model.find(value));
+            assert(list->searchNoReorder(value) == model.find(value));
+        }
+        else if (operation == 5 && size > 0 && size < Capacity)
+        {
+            int after = model.items[generator() % size];
+            list->insertAfter(value, after); // the lookup of after is reordered too
+            int pos = model.reorder(model.find(after));
+            model.insert(pos + 1, value);
+        }
+        else if (operation == 6)
+        {
+            CountingList<Capacity> copy(*list); // the counts follow the copies
+            *list = copy;
+        }
+        else if (operation == 7 && size > 0)
+        {
+            list->deleteLast();
+            model.erase(size - 1);
+        }
+        assert(contents(*list) == model.items);
+    }
+}
+
+int main()
+{
+    cout.setstate(ios::failbit); // the list reports every operation
+    mt19937 generator(3);
+    ReorderPolicy policies[] = {NO_REORDER, MOVE_TO_FRONT, TRANSPOSE, COUNT_ORDER};
+    for (ReorderPolicy policy : policies)
+    {
+        testAgainstModel<40>(generator, policy);
+        testAgainstModel<300>(generator, policy);
+    }
+
+    // Lists without counters refuse COUNT_ORDER and keep their policy
+    ArrayBasedList<int, 10> plain;
+    plain.setReorderPolicy(TRANSPOSE);
+    plain.setReorderPolicy(COUNT_ORDER);
+    assert(plain.getReorderPolicy() == TRANSPOSE);
+    static_assert(sizeof(ArrayBasedList<int, 1000>) < sizeof(NodePool<int, 1000>) + 64,
+                  "a list without counters is its pool plus a few indices");
+    static_assert(sizeof(CountingList<1000>) >= sizeof(ArrayBasedList<int, 1000>) + 1000 * sizeof(unsigned));
+
+    // Move-to-front on a list of strings
+    ArrayBasedList<string, 10> names;
+    names.setReorderPolicy(MOVE_TO_FRONT);
+    names.insertLast("a");
+    names.insertLast("b");
+    int before = names.search("b");
+    int after = names.search("b");
+    assert(before == 1 && after == 0);
+
+    // Searching a copy-on-write list never reorders the shared list
+    CowArrayBasedList<string, 10> shared;
+    shared.insertLast("a");
+    shared.insertLast("b");
+    CowArrayBasedList<string, 10> snapshot = shared;
+    assert(snapshot.search("b") == 1 && snapshot.search("b") == 1 && shared.search("b") == 1);
+    cout.clear();
+    cout << "ReorderPolicy tests passed" << endl;
+    return 0;
+}
@@ -0,0 +1,187 @@
+/**--SearchTest.cpp-------------------------------------------------------------------------
+    Tests of the searches, which walk the list from both ends at once (walkFromBothEnds):
+    search, searchNoReorder, insertAfter and deleteElement must act on the first occurrence
+    of a key, and searchMany must give the first position of every key, on lists of every
+    size (empty, odd, even) full of duplicates. searchMany is checked with few keys (every
+    node compared with every key) and with many (hash table of the keys), with repeated and
+    missing keys, keys only found near the tail, and a hash that sends every key to the
+    same slots. Everything is compared with a vector model.
+
+    Build and run (from the repository root):
+        g++ -std=c++20 -O2 -I. tests/SearchTest.cpp -o search_test && ./search_test
+-------------------------------------------------------------------------------------------*/
+#include "ArrayBasedList.h"
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**--CollidingHash--------------------------------------------------
+ Sends every key to slot 0 or 1, so the keys of searchMany form one
+ long probe sequence.
+ ---------------------------------------------------------------**/
+struct CollidingHash
+{
+    size_t operator()(int key) const
+    {
+        return size_t(key % 2);
+    }
+};
+
+/***** firstPosition *****/
+int firstPosition(const vector<int> &model, int key)
+{
+    auto found = find(model.begin(), model.end(), key);
+    return found == model.end() ? -1 : int(found - model.begin());
+}
+
+/***** contents *****/
+template <typename List>
+vector<int> contents(const List &list)
+{
+    vector<int> items;
+    list.forEachReverse([&](int item)
+                        { items.insert(items.begin(), item); });
+    return items;
+}
+
+/***** testSearchMany *****/
+/*------------------------------------------------------
+    Lists of every size up to 40, with values in [0, range): many
+    duplicates when range is small. The keys mix values of the list
+    (some repeated), values only present near the tail, and values
+    absent from the list.
+-------------------------------------------------------*/
+template <typename Hash>
+void testSearchMany(mt19937 &generator)
+{
+    typedef ArrayBasedList<int, 64, 0, equal_to<int>, Hash> List;
+    for (int size = 0; size <= 40; size++)
+    {
+        for (int range : {3, 10, 1000})
+        {
+            List list;
+            vector<int> model;
+            for (int i = 0; i < size; i++)
+            {
+                int value = int(generator() % range);
+                list.insertLast(value);
+                model.push_back(value);
+            }
+            if (size >= 2 && range == 1000)
+            {
+                // Two values only at the tail, the second one twice
+                list.deleteLast();
+                list.deleteLast();
+                model.resize(size - 2);
+                for (int value : {5000, 6000})
+                {
+                    list.insertLast(value);
+                    model.push_back(value);
+                }
+                list.insertAtPos(6000, size - 1);
+                model.insert(model.end() - 1, 6000);
+            }
+            for (int keyCount : {1, 3, 8, 9, 20, 50})
+            {
+                vector<int> keys;
+                for (int k = 0; k < keyCount; k++)
+                {
+                    int choice = int(generator() % 4);
+                    if (choice == 0 && !keys.empty())
+                        keys.push_back(keys[generator() % keys.size()]); // a repeated key
+                    else if (choice == 1)
+                        keys.push_back(range + int(generator() % 7)); // absent
+                    else if (choice == 2 && !model.empty())
+                        keys.push_back(model.back()); // at the tail (maybe earlier too)
+                    else
+                        keys.push_back(int(generator() % range));
+                }
+                vector<int> positions = list.searchMany(keys);
+                assert(positions.size() == keys.size());
+                for (int k = 0; k < keyCount; k++)
+                    assert(positions[k] == firstPosition(model, keys[k]));
+            }
+            assert(contents(list) == model); // searchMany never reorders
+        }
+    }
+}
+
+/***** testFirstOccurrence *****/
+/*------------------------------------------------------
+    search and searchNoReorder give the first position of every value
+    (the tail walk may see a later occurrence first), and insertAfter
+    and deleteElement act on that occurrence.
+-------------------------------------------------------*/
+void testFirstOccurrence(mt19937 &generator)
+{
+    typedef ArrayBasedList<int, 64> List;
+    for (int round = 0; round < 2000; round++)
+    {
+        List list;
+        vector<int> model;
+        int size = int(generator() % 41);
+        for (int i = 0; i < size; i++)
+        {
+            int value = int(generator() % 6);
+            list.insertLast(value);
+            model.push_back(value);
+        }
+        for (int value = 0; value < 7; value++)
+        {
+            int expected = firstPosition(model, value);
+            int found = list.searchNoReorder(value);
+            int searched = list.search(value);
+            assert(found == expected && searched == expected);
+        }
+        int value = int(generator() % 7);
+        int pos = firstPosition(model, value);
+        if (generator() % 2 == 0)
+        {
+            list.insertAfter(100, value);
+            if (pos != -1)
+                model.insert(model.begin() + pos + 1, 100);
+        }
+        else
+        {
+            list.deleteElement(value);
+            if (pos != -1)
+                model.erase(model.begin() + pos);
+        }
+        assert(contents(list) == model && list.getsize() == int(model.size()));
+    }
+}
+
+/***** testStrings *****/
+void testStrings()
+{
+    ArrayBasedList<string, 32, 0, equal_to<>> list;
+    vector<string> keys;
+    for (int i = 0; i < 15; i++)
+        list.insertLast("name " + to_string(i % 5)); // every name three times
+    for (int i = 0; i < 12; i++)
+        keys.push_back("name " + to_string(i % 6)); // "name 5" is absent
+    vector<int> positions = list.searchMany(keys);
+    for (int i = 0; i < 12; i++)
+        assert(positions[i] == (i % 6 == 5 ? -1 : i % 6));
+    vector<const char *> texts = {"name 4", "name 0", "missing"};
+    positions = list.searchMany(texts);
+    assert((positions == vector<int>{4, 0, -1}));
+}
+
+int main()
+{
+    cout.setstate(ios::failbit); // the list reports every operation
+    mt19937 generator(17);
+    testSearchMany<hash<int>>(generator);
+    testSearchMany<CollidingHash>(generator);
+    testSearchMany<void>(generator); // no hash: every key compared directly
+    testFirstOccurrence(generator);
+    testStrings();
+    cout.clear();
+    cout << "Search tests passed" << endl;
+    return 0;
+}
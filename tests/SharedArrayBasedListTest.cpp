@@ -0,0 +1,94 @@
+/**--SharedArrayBasedListTest.cpp-----------------------------------------------------------
+    Tests of SharedArrayBasedList: child processes read a list filled by the parent in
+    place, segments of another layout are rejected (including another element type of the
+    same size), a process dying while holding the mutex does not block the others, and a
+    name cannot be created twice.
+
+    Build and run (from the repository root, POSIX):
+        g++ -std=c++20 -O2 -I. tests/SharedArrayBasedListTest.cpp -o shared_list_test && ./shared_list_test
+-------------------------------------------------------------------------------------------*/
+#include "SharedArrayBasedList.h"
+#include "InlineString.h"
+#include <cassert>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+/***** childSucceeded *****/
+/*------------------------------------------------------
+    Runs body in a child process and tells whether it returned true.
+-------------------------------------------------------*/
+template <typename Body>
+bool childSucceeded(Body body)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+        _exit(body() ? 0 : 1);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main()
+{
+    typedef SharedArrayBasedList<int, 2000> SharedList;
+    const string name = "/shared-list-test-" + to_string(getpid());
+
+    {
+        SharedList owner(name, CREATE_SEGMENT);
+        assert(owner.isOpen());
+        cout.setstate(ios::failbit); // the list and the failed opens below report themselves
+        owner.write([](auto &list)
+                    {
+                        for (int i = 0; i < 1000; i++)
+                            list.insertLast(i); });
+
+        // Readers in other processes see the list in place
+        for (int c = 0; c < 3; c++)
+        {
+            assert(childSucceeded([&]
+                                  {
+                                      SharedList reader(name, OPEN_SEGMENT);
+                                      if (!reader.isOpen())
+                                          return false;
+                                      long sum = 0;
+                                      reader.read([&](const auto &list)
+                                                  { list.forEachReverse([&](int v)
+                                                                        { sum += v; }); });
+                                      int position = reader.read([c](const auto &list)
+                                                                 { return list.search(c * 100); });
+                                      return sum == 499500 && position == c * 100; }));
+        }
+
+        // Another Capacity, or another element type of the same size, is rejected
+        assert(childSucceeded([&]
+                              { return !SharedArrayBasedList<int, 2001>(name, OPEN_SEGMENT).isOpen(); }));
+        assert(childSucceeded([&]
+                              { return !SharedArrayBasedList<float, 2000>(name, OPEN_SEGMENT).isOpen(); }));
+
+        // A writer that dies holding the mutex does not block the others
+        childSucceeded([&]
+                       {
+                           SharedList writer(name, OPEN_SEGMENT);
+                           writer.write([](auto &)
+                                        { _exit(0); });
+                           return false; });
+        int size = owner.write([](auto &list)
+                               { return list.getsize(); });
+        assert(size == 1000);
+
+        // The name is taken, and a missing segment cannot be opened
+        SharedList duplicate(name, CREATE_SEGMENT);
+        assert(!duplicate.isOpen());
+        SharedArrayBasedList<ShortString, 10> missing(name + "-missing", OPEN_SEGMENT);
+        assert(!missing.isOpen());
+        cout.clear();
+    }
+    bool removed = SharedList::remove(name);
+    bool removedTwice = SharedList::remove(name);
+    assert(removed && !removedTwice);
+    cout << "SharedArrayBasedList tests passed" << endl;
+    return 0;
+}